@@ -0,0 +1,209 @@
+// Shows the effect of MemPool's cache-line layout and of the
+// `avoid_4k_aliasing` stride option.
+//
+//   contention: W threads allocate/release in a loop while one reader per
+//               writer polls the pool's geometry (capacity(), owns(), ...).
+//               With hot and cold state on shared lines, reader throughput
+//               collapses as writers are added. Runs against MemPool and a
+//               minimal locked pool in two layouts: geometry sharing a line
+//               with the lock (the false-sharing control) and on its own.
+//   aliasing:   streams `dst[i] = a * src[i] + b` between adjacent blocks
+//               whose stride is exactly 4 KiB, with and without padding.
+//
+// Usage: mempool_layout [max_threads] [milliseconds_per_run]
+
+#include "nstd/memory/mempool/MemPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+using Pool = nstd::memory::MemPool<float>;
+
+/**
+ * Minimal locked pool with MemPool's geometry accessors. With `Padded` false
+ * the read-mostly geometry shares a cache line with the mutex every
+ * acquire/release writes (the object starts on a line, so they always
+ * share one); with `Padded` true the mutex starts a new line.
+ */
+template <bool Padded> class alignas(64) control_pool {
+public:
+  control_pool(std::size_t block_size, std::size_t block_count)
+      : block_size_(block_size), block_count_(block_count),
+        storage_(block_size * block_count) {
+    data_ = storage_.data();
+    for (std::size_t i = 0; i < block_count; ++i) {
+      free_.push_back(data_ + i * block_size);
+    }
+  }
+
+  float *acquire_block() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (free_.empty()) {
+      return nullptr;
+    }
+    float *block = free_.back();
+    free_.pop_back();
+    ++in_use_;
+    return block;
+  }
+
+  void release_block(float *block) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    free_.push_back(block);
+    --in_use_;
+  }
+
+  std::size_t capacity() const noexcept { return block_count_; }
+  std::size_t block_size() const noexcept { return block_size_; }
+  std::size_t stride() const noexcept { return block_size_; }
+  bool owns(const float *p) const noexcept {
+    return p >= data_ && p < data_ + block_size_ * block_count_;
+  }
+
+private:
+  std::size_t block_size_;
+  std::size_t block_count_;
+  float *data_ = nullptr;
+  alignas(Padded ? 64 : alignof(std::mutex)) std::mutex mtx_;
+  std::size_t in_use_ = 0;
+  std::vector<float *> free_;
+  std::vector<float> storage_;
+};
+
+struct contention_result {
+  double writer_ops_per_sec = 0;
+  double reader_ops_per_sec = 0;
+};
+
+template <typename P>
+contention_result run_contention(std::size_t writers,
+                                 std::chrono::milliseconds duration) {
+  P pool(256, writers * 4);
+  std::atomic<bool> start{false};
+  std::atomic<bool> stop{false};
+  std::atomic<std::uint64_t> writer_ops{0};
+  std::atomic<std::uint64_t> reader_ops{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t w = 0; w < writers; ++w) {
+    threads.emplace_back([&] {
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      std::uint64_t ops = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        float *block = pool.acquire_block();
+        if (block) {
+          block[0] = 1.0f;
+          pool.release_block(block);
+        }
+        ++ops;
+      }
+      writer_ops.fetch_add(ops, std::memory_order_relaxed);
+    });
+    threads.emplace_back([&] {
+      // Re-read the pool through a volatile pointer so the geometry loads
+      // can't be hoisted out of the loop.
+      P *volatile view = &pool;
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      std::uint64_t ops = 0;
+      std::size_t sink = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        P *p = view;
+        sink += p->capacity() + p->block_size() + p->stride();
+        sink += p->owns(nullptr) ? 1 : 0;
+        ++ops;
+      }
+      reader_ops.fetch_add(ops + (sink == 0 ? 1 : 0),
+                           std::memory_order_relaxed);
+    });
+  }
+
+  auto begin = clock_type::now();
+  start.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(duration);
+  stop.store(true, std::memory_order_relaxed);
+  for (auto &t : threads) {
+    t.join();
+  }
+  double seconds =
+      std::chrono::duration<double>(clock_type::now() - begin).count();
+  return {static_cast<double>(writer_ops.load()) / seconds,
+          static_cast<double>(reader_ops.load()) / seconds};
+}
+
+double run_aliasing(bool avoid_aliasing, std::size_t passes) {
+  constexpr std::size_t block_size = 1024; // 4 KiB of floats
+  constexpr std::size_t block_count = 64;
+  nstd::memory::MemPoolOptions options;
+  options.avoid_4k_aliasing = avoid_aliasing;
+  Pool pool(block_size, block_count, nstd::memory::MemoryLocation::Host,
+            options);
+
+  std::vector<Pool::buffer_type> blocks;
+  for (std::size_t i = 0; i < block_count; ++i) {
+    blocks.push_back(pool.allocate());
+    for (auto &x : blocks.back().span()) {
+      x = 1.0f;
+    }
+  }
+
+  auto begin = clock_type::now();
+  for (std::size_t pass = 0; pass < passes; ++pass) {
+    for (std::size_t b = 0; b + 1 < block_count; ++b) {
+      const float *src = blocks[b].get();
+      float *dst = blocks[b + 1].get();
+      for (std::size_t i = 0; i < block_size; ++i) {
+        dst[i] = src[i] * 0.5f + 0.5f;
+      }
+    }
+  }
+  double seconds =
+      std::chrono::duration<double>(clock_type::now() - begin).count();
+  double bytes = static_cast<double>(passes * (block_count - 1) * block_size *
+                                     sizeof(float) * 2);
+  return bytes / seconds / 1e9;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t max_threads = std::thread::hardware_concurrency() / 2;
+  if (argc > 1) {
+    max_threads = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (max_threads == 0) {
+    max_threads = 1;
+  }
+  std::chrono::milliseconds duration(argc > 2 ? std::atoi(argv[2]) : 500);
+
+  std::printf("contention (pool sizeof=%zu, alignof=%zu)\n", sizeof(Pool),
+              alignof(Pool));
+  std::printf("%-16s %8s %18s %18s\n", "layout", "writers", "writer ops/s",
+              "reader ops/s");
+  auto report = [](const char *layout, std::size_t writers,
+                   contention_result result) {
+    std::printf("%-16s %8zu %18.0f %18.0f\n", layout, writers,
+                result.writer_ops_per_sec, result.reader_ops_per_sec);
+  };
+  for (std::size_t writers = 1; writers <= max_threads; writers *= 2) {
+    report("MemPool", writers, run_contention<Pool>(writers, duration));
+    report("shared line", writers,
+           run_contention<control_pool<false>>(writers, duration));
+    report("separate lines", writers,
+           run_contention<control_pool<true>>(writers, duration));
+  }
+
+  std::printf("\naliasing (adjacent 4 KiB blocks)\n");
+  std::printf("%16s %10s\n", "stride", "GB/s");
+  constexpr std::size_t passes = 2000;
+  std::printf("%16s %10.2f\n", "4096", run_aliasing(false, passes));
+  std::printf("%16s %10.2f\n", "4096 + 64", run_aliasing(true, passes));
+  return 0;
+}
@@ -0,0 +1,201 @@
+// MPMC throughput and tail-latency sweep for MemPool.
+//
+// For every combination of thread count, block size and batch size, each
+// thread repeatedly acquires `batch` blocks, touches them and releases them
+// (symmetric mode). In skewed mode half of the threads only acquire and hand
+// their blocks over a queue to the other half, which only release, so every
+// block is returned by a different thread than the one that took it.
+//
+// Reported: total acquire+release pairs per second and the p50/p99/p999
+// latency of a single acquire_block() call.
+//
+// Usage: mempool_mpmc [max_threads] [ops_per_thread]
+
+#include "nstd/memory/mempool/MemPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+using Pool = nstd::memory::MemPool<std::byte>;
+
+struct run_result {
+  double ops_per_sec = 0;
+  std::uint64_t p50_ns = 0;
+  std::uint64_t p99_ns = 0;
+  std::uint64_t p999_ns = 0;
+};
+
+/// Blocks passed from acquiring to releasing threads in skewed mode
+class handoff_queue {
+public:
+  void push(std::vector<std::byte *> &blocks) {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      queue_.insert(queue_.end(), blocks.begin(), blocks.end());
+    }
+    blocks.clear();
+    ready_.notify_one();
+  }
+
+  /// @return false once closed and empty
+  bool pop(std::vector<std::byte *> &out, std::size_t max) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    ready_.wait(lock, [this] { return !queue_.empty() || closed_; });
+    if (queue_.empty()) {
+      return false;
+    }
+    std::size_t n = std::min(max, queue_.size());
+    out.assign(queue_.begin(), queue_.begin() + n);
+    queue_.erase(queue_.begin(), queue_.begin() + n);
+    return true;
+  }
+
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      closed_ = true;
+    }
+    ready_.notify_all();
+  }
+
+private:
+  std::mutex mtx_;
+  std::condition_variable ready_;
+  std::deque<std::byte *> queue_;
+  bool closed_ = false;
+};
+
+/// Acquire with retry (the pool may be momentarily empty in skewed mode)
+std::byte *timed_acquire(Pool &pool, std::vector<std::uint64_t> &latencies) {
+  while (true) {
+    auto start = clock_type::now();
+    std::byte *block = pool.acquire_block();
+    auto end = clock_type::now();
+    if (block) {
+      latencies.push_back(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+              .count()));
+      return block;
+    }
+    std::this_thread::yield();
+  }
+}
+
+std::uint64_t percentile(std::vector<std::uint64_t> &sorted, double q) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<std::size_t>(q * static_cast<double>(sorted.size()));
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+run_result run(std::size_t threads, std::size_t block_bytes, std::size_t batch,
+               std::size_t ops_per_thread, bool skewed) {
+  std::size_t acquirers = skewed ? std::max<std::size_t>(threads / 2, 1)
+                                 : threads;
+  std::size_t releasers = skewed ? std::max<std::size_t>(threads - acquirers, 1)
+                                 : 0;
+  Pool pool(block_bytes, acquirers * batch * 4);
+  handoff_queue queue;
+  std::vector<std::vector<std::uint64_t>> latencies(acquirers);
+  std::atomic<bool> start{false};
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < acquirers; ++t) {
+    workers.emplace_back([&, t] {
+      auto &lat = latencies[t];
+      lat.reserve(ops_per_thread);
+      std::vector<std::byte *> held;
+      held.reserve(batch);
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      for (std::size_t done = 0; done < ops_per_thread; done += batch) {
+        for (std::size_t i = 0; i < batch; ++i) {
+          held.push_back(timed_acquire(pool, lat));
+          std::memset(held.back(), 1, 64 < block_bytes ? 64 : block_bytes);
+        }
+        if (skewed) {
+          queue.push(held);
+        } else {
+          for (std::byte *block : held) {
+            pool.release_block(block);
+          }
+          held.clear();
+        }
+      }
+    });
+  }
+  for (std::size_t t = 0; t < releasers; ++t) {
+    workers.emplace_back([&] {
+      std::vector<std::byte *> blocks;
+      while (queue.pop(blocks, batch)) {
+        for (std::byte *block : blocks) {
+          pool.release_block(block);
+        }
+      }
+    });
+  }
+
+  auto begin = clock_type::now();
+  start.store(true, std::memory_order_release);
+  for (std::size_t t = 0; t < acquirers; ++t) {
+    workers[t].join();
+  }
+  queue.close();
+  for (std::size_t t = acquirers; t < workers.size(); ++t) {
+    workers[t].join();
+  }
+  double seconds =
+      std::chrono::duration<double>(clock_type::now() - begin).count();
+
+  std::vector<std::uint64_t> all;
+  for (auto &lat : latencies) {
+    all.insert(all.end(), lat.begin(), lat.end());
+  }
+  std::sort(all.begin(), all.end());
+  return {static_cast<double>(all.size()) / seconds, percentile(all, 0.5),
+          percentile(all, 0.99), percentile(all, 0.999)};
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t max_threads = std::thread::hardware_concurrency();
+  if (argc > 1) {
+    max_threads = std::strtoul(argv[1], nullptr, 10);
+  }
+  max_threads = std::max<std::size_t>(max_threads, 1);
+  std::size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+  const std::size_t block_sizes[] = {64, 4096};
+  const std::size_t batch_sizes[] = {1, 16, 64};
+
+  std::printf("%-9s %7s %7s %5s %14s %8s %8s %8s\n", "mode", "threads",
+              "bytes", "batch", "ops/s", "p50 ns", "p99 ns", "p999 ns");
+  for (bool skewed : {false, true}) {
+    for (std::size_t threads = skewed ? 2 : 1; threads <= max_threads;
+         threads *= 2) {
+      for (std::size_t bytes : block_sizes) {
+        for (std::size_t batch : batch_sizes) {
+          auto r = run(threads, bytes, batch, ops, skewed);
+          std::printf("%-9s %7zu %7zu %5zu %14.0f %8llu %8llu %8llu\n",
+                      skewed ? "skewed" : "symmetric", threads, bytes, batch,
+                      r.ops_per_sec,
+                      static_cast<unsigned long long>(r.p50_ns),
+                      static_cast<unsigned long long>(r.p99_ns),
+                      static_cast<unsigned long long>(r.p999_ns));
+        }
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,176 @@
+// Cost of the allocate -> share -> release loop for shared_buffers, and how
+// many global-heap operations each iteration performs.
+//
+// Every iteration allocates one buffer, makes `copies` more owners of it,
+// touches the data and drops every owner. Variants:
+//
+//   make_shared:     make_shared_buffer(), one heap block for data and
+//                    control block
+//   erased:          pool block through the type-erased unique_buffer<T>, so
+//                    the control block (and its deleter) come from the heap
+//   converted:       shared_buffer(pool.allocate()), pooled control block
+//   allocate_shared: pool.allocate_shared(), pooled control block
+//
+// Heap operations are counted by replacing the global operator new/delete;
+// the pooled variants should report zero once the pool is warm.
+//
+// Usage: shared_recycling [threads] [iterations_per_thread]
+
+#include "nstd/memory/mempool/MemPool.hpp"
+#include "nstd/memory/smart_buffers/shared_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+std::atomic<std::uint64_t> heap_ops{0};
+} // namespace
+
+void *operator new(std::size_t size) {
+  heap_ops.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+  if (p) {
+    heap_ops.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+
+void *operator new(std::size_t size, std::align_val_t align) {
+  heap_ops.fetch_add(1, std::memory_order_relaxed);
+  auto alignment = static_cast<std::size_t>(align);
+  size = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment *
+         alignment;
+  if (void *p = std::aligned_alloc(alignment, size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+  if (p) {
+    heap_ops.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t align) noexcept {
+  operator delete(p, align);
+}
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+using Pool = nstd::memory::MemPool<float>;
+constexpr std::size_t block_size = 256;
+constexpr std::size_t copies = 3;
+
+enum class Variant { MakeShared, Erased, Converted, AllocateShared };
+
+const char *name(Variant v) {
+  switch (v) {
+  case Variant::MakeShared:
+    return "make_shared";
+  case Variant::Erased:
+    return "erased";
+  case Variant::Converted:
+    return "converted";
+  case Variant::AllocateShared:
+    return "allocate_shared";
+  }
+  return "";
+}
+
+nstd::memory::shared_buffer<float> make(Variant v, Pool &pool) {
+  switch (v) {
+  case Variant::MakeShared:
+    return nstd::memory::make_shared_buffer_for_overwrite<float>(block_size);
+  case Variant::Erased:
+    return nstd::memory::shared_buffer<float>(
+        nstd::memory::unique_buffer<float>(pool.allocate()));
+  case Variant::Converted:
+    return nstd::memory::shared_buffer<float>(pool.allocate());
+  case Variant::AllocateShared:
+    return pool.allocate_shared();
+  }
+  return {};
+}
+
+struct result {
+  double ns_per_iteration = 0;
+  double heap_ops_per_iteration = 0;
+};
+
+result run(Variant variant, std::size_t threads, std::size_t iterations) {
+  Pool pool(block_size, threads);
+  // Warm up: first-use setup (the slot list, lazy pages) is not steady state.
+  for (std::size_t i = 0; i < threads; ++i) {
+    make(variant, pool).reset();
+  }
+
+  std::atomic<bool> start{false};
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&] {
+      nstd::memory::shared_buffer<float> owners[copies];
+      while (!start.load(std::memory_order_acquire)) {
+      }
+      for (std::size_t i = 0; i < iterations; ++i) {
+        auto sb = make(variant, pool);
+        for (auto &owner : owners) {
+          owner = sb;
+        }
+        sb.span()[i % block_size] = 1.0f;
+        sb.reset();
+        for (auto &owner : owners) {
+          owner.reset();
+        }
+      }
+    });
+  }
+  // Thread creation itself allocates; count only the loop.
+  std::uint64_t heap_before = heap_ops.load();
+  auto begin = clock_type::now();
+  start.store(true, std::memory_order_release);
+  for (auto &t : workers) {
+    t.join();
+  }
+  double seconds =
+      std::chrono::duration<double>(clock_type::now() - begin).count();
+  std::uint64_t heap = heap_ops.load() - heap_before;
+  double total = static_cast<double>(threads * iterations);
+  return {seconds * 1e9 * static_cast<double>(threads) / total,
+          static_cast<double>(heap) / total};
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+  max_threads = std::max<std::size_t>(max_threads, 1);
+  std::size_t iterations =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+
+  std::printf("%-16s %7s %14s %14s\n", "variant", "threads", "ns/iteration",
+              "heap ops/iter");
+  for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+    for (Variant v : {Variant::MakeShared, Variant::Erased,
+                      Variant::Converted, Variant::AllocateShared}) {
+      auto r = run(v, threads, iterations);
+      std::printf("%-16s %7zu %14.1f %14.2f\n", name(v), threads,
+                  r.ns_per_iteration, r.heap_ops_per_iteration);
+    }
+  }
+  return 0;
+}
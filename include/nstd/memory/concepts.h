@@ -15,6 +15,10 @@ template <typename PointerT, typename T>
 concept PointerLike =
     std::same_as<PointerT, T *> || std::same_as<PointerT, const T *>;
 
+/// Types whose object representation may be reinterpreted (memcpy-safe)
+template <typename T>
+concept TriviallyCopyable = std::is_trivially_copyable_v<T>;
+
 template <class BuffT, typename T>
 concept SmartBuffer = requires(BuffT smart_buffer) {
   { smart_buffer.size() } -> std::convertible_to<size_t>;
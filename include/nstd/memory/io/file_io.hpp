@@ -0,0 +1,363 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "../numa.hpp"
+#include "../smart_buffers/buffer_chain.hpp"
+#include "../smart_buffers/unique_buffer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+/**
+ * Zero-copy file I/O on top of the smart buffers: map a file straight into a
+ * buffer, read it with O_DIRECT into aligned memory, and write buffers (or
+ * whole buffer chains) out with a single gathering `pwritev()`.
+ *
+ * Failures are reported as `std::system_error` carrying the `errno`.
+ */
+namespace nstd::memory::io {
+/**
+ * @brief Move-only owner of a file descriptor.
+ */
+class file_descriptor {
+public:
+  file_descriptor() noexcept = default;
+
+  /// Adopt `fd` (closed on destruction)
+  explicit file_descriptor(int fd) noexcept : fd_(fd) {}
+
+  file_descriptor(const file_descriptor &) = delete;
+  file_descriptor &operator=(const file_descriptor &) = delete;
+
+  file_descriptor(file_descriptor &&other) noexcept
+      : fd_(std::exchange(other.fd_, -1)) {}
+
+  file_descriptor &operator=(file_descriptor &&other) noexcept {
+    if (this != &other) {
+      close();
+      fd_ = std::exchange(other.fd_, -1);
+    }
+    return *this;
+  }
+
+  ~file_descriptor() { close(); }
+
+  int get() const noexcept { return fd_; }
+
+  explicit operator bool() const noexcept { return fd_ >= 0; }
+
+  /// Give up ownership without closing
+  int release() noexcept { return std::exchange(fd_, -1); }
+
+  void close() noexcept {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+private:
+  int fd_ = -1;
+};
+
+/**
+ * @brief `open(2)` with `O_CLOEXEC`.
+ * @throws std::system_error on failure.
+ */
+inline file_descriptor open_file(const std::string &path, int flags,
+                                 mode_t mode = 0644) {
+  int fd = ::open(path.c_str(), flags | O_CLOEXEC, mode);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "open_file: " + path);
+  }
+  return file_descriptor(fd);
+}
+
+/**
+ * @return The size of the file behind `fd` in bytes.
+ * @throws std::system_error on failure.
+ */
+inline std::uint64_t file_size(int fd) {
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    throw std::system_error(errno, std::generic_category(), "file_size");
+  }
+  return static_cast<std::uint64_t>(st.st_size);
+}
+
+/// How `map_file()` maps a file
+enum class MapMode {
+  ReadOnly, ///< PROT_READ, MAP_SHARED: writing through the buffer faults
+  Private   ///< Writable copy-on-write mapping; changes never reach the file
+};
+
+/**
+ * @brief Deleter of mapped buffers: unmaps the whole mapping, which may start
+ * before the buffer's data when the file offset wasn't page aligned.
+ */
+struct munmap_deleter {
+  void *base = nullptr;
+  std::size_t length = 0;
+
+  template <typename T> void operator()(T *) const noexcept {
+    ::munmap(base, length);
+  }
+};
+
+using mapped_buffer = unique_buffer<std::byte, munmap_deleter>;
+
+/// "Up to the end of the file" length for `map_file()`
+inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+/**
+ * @brief Maps `length` bytes of a file starting at `offset` into a buffer.
+ *
+ * No data is copied: pages are faulted in from the page cache on first
+ * access. The mapping outlives `fd`. Convert the result to a
+ * `shared_buffer<std::byte>` to share it, or reinterpret it with
+ * `unique_buffer_cast`.
+ *
+ * @param offset Any byte offset; the mapping is extended down to the page
+ * boundary internally.
+ * @param length Number of bytes, or `npos` for everything up to the end of
+ * the file.
+ * @param populate Fault every page in up front (MAP_POPULATE).
+ *
+ * @return The mapping, or an empty buffer if the range is empty.
+ * @throws std::system_error if the file cannot be mapped.
+ * @throws std::out_of_range if the range extends past the end of the file.
+ */
+inline mapped_buffer map_file(int fd, MapMode mode, std::uint64_t offset = 0,
+                              std::size_t length = npos,
+                              bool populate = false) {
+  std::uint64_t size = file_size(fd);
+  if (offset > size || (length != npos && length > size - offset)) {
+    throw std::out_of_range("map_file: range exceeds the file size");
+  }
+  if (length == npos) {
+    length = static_cast<std::size_t>(size - offset);
+  }
+  if (length == 0) {
+    return mapped_buffer();
+  }
+  std::uint64_t page = numa::page_size();
+  std::uint64_t start = offset / page * page;
+  auto head = static_cast<std::size_t>(offset - start);
+
+  int prot = mode == MapMode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+  int flags = mode == MapMode::ReadOnly ? MAP_SHARED : MAP_PRIVATE;
+  if (populate) {
+    flags |= MAP_POPULATE;
+  }
+  void *base = ::mmap(nullptr, head + length, prot, flags, fd,
+                      static_cast<off_t>(start));
+  if (base == MAP_FAILED) {
+    throw std::system_error(errno, std::generic_category(), "map_file");
+  }
+  return mapped_buffer(static_cast<std::byte *>(base) + head, length,
+                       munmap_deleter{base, head + length});
+}
+
+/// Opens `path` read-only and maps all of it; see above.
+inline mapped_buffer map_file(const std::string &path,
+                              MapMode mode = MapMode::ReadOnly,
+                              bool populate = false) {
+  file_descriptor fd = open_file(path, O_RDONLY);
+  return map_file(fd.get(), mode, 0, npos, populate);
+}
+
+/// Alignment of O_DIRECT buffers, offsets and lengths (the page size covers
+/// every common logical block size)
+inline std::size_t direct_io_alignment() noexcept { return numa::page_size(); }
+
+using aligned_buffer = unique_buffer<std::byte, aligned_deleter<std::byte>>;
+
+/**
+ * @brief `pread()` until `buffer` is full or the end of the file is reached.
+ *
+ * On an O_DIRECT descriptor a short read ends the call as well: resuming it
+ * would need an unaligned offset and buffer address, which O_DIRECT rejects.
+ *
+ * @return The number of bytes read (less than `buffer.size()` at EOF, or
+ * after a short O_DIRECT read).
+ * @throws std::system_error on failure.
+ */
+inline std::size_t read_at(int fd, std::span<std::byte> buffer,
+                           std::uint64_t offset) {
+  bool direct = false;
+#if defined(O_DIRECT)
+  int flags = ::fcntl(fd, F_GETFL);
+  direct = flags >= 0 && (flags & O_DIRECT) != 0;
+#endif
+  std::size_t done = 0;
+  while (done < buffer.size()) {
+    std::size_t wanted = buffer.size() - done;
+    ssize_t n = ::pread(fd, buffer.data() + done, wanted,
+                        static_cast<off_t>(offset + done));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "read_at");
+    }
+    if (n == 0) {
+      break;
+    }
+    done += static_cast<std::size_t>(n);
+    if (direct && static_cast<std::size_t>(n) < wanted) {
+      break;
+    }
+  }
+  return done;
+}
+
+/**
+ * @brief Reads a whole file with O_DIRECT, bypassing the page cache, into a
+ * buffer aligned to `direct_io_alignment()`.
+ *
+ * Filesystems without O_DIRECT support (e.g. tmpfs, or ones that only reject
+ * it at read time) fall back to a regular buffered read into the same
+ * aligned buffer, as does whatever a short direct read left over.
+ *
+ * @return A buffer of exactly the file's size (empty for an empty file).
+ * @throws std::system_error if the file cannot be opened or read.
+ * @throws std::bad_alloc if the buffer cannot be allocated.
+ */
+inline aligned_buffer read_file_direct(const std::string &path) {
+  file_descriptor fd;
+  bool direct = false;
+#if defined(O_DIRECT)
+  int direct_fd = ::open(path.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+  if (direct_fd >= 0) {
+    fd = file_descriptor(direct_fd);
+    direct = true;
+  } else if (errno != EINVAL) {
+    throw std::system_error(errno, std::generic_category(),
+                            "read_file_direct: " + path);
+  }
+#endif
+  if (!fd) {
+    fd = open_file(path, O_RDONLY);
+  }
+  std::uint64_t size = file_size(fd.get());
+  if (size == 0) {
+    return aligned_buffer();
+  }
+  std::size_t alignment = direct_io_alignment();
+  std::size_t capacity =
+      (static_cast<std::size_t>(size) + alignment - 1) / alignment * alignment;
+  std::unique_ptr<std::byte, aligned_deleter<std::byte>> memory(
+      static_cast<std::byte *>(std::aligned_alloc(alignment, capacity)));
+  if (!memory) {
+    throw std::bad_alloc();
+  }
+  // O_DIRECT lengths must be block multiples: read the rounded-up capacity,
+  // the kernel stops at EOF.
+  std::size_t n = 0;
+  if (direct) {
+    try {
+      n = read_at(fd.get(), {memory.get(), capacity}, 0);
+    } catch (const std::system_error &e) {
+      if (e.code() != std::errc::invalid_argument) {
+        throw;
+      }
+      n = 0; // O_DIRECT accepted by open() but not by read: redo it buffered
+    }
+    if (n < size) {
+      fd = open_file(path, O_RDONLY);
+    }
+  }
+  if (n < size) {
+    n += read_at(fd.get(), {memory.get() + n, capacity - n}, n);
+  }
+  return aligned_buffer(memory.release(), n, aligned_deleter<std::byte>{});
+}
+
+/**
+ * @brief Gathering write: `pwritev()` until every byte of `iov` is written.
+ *
+ * Partial writes are resumed and vectors longer than `IOV_MAX` are split.
+ *
+ * @return The number of bytes written.
+ * @throws std::system_error on failure, with EIO if a write makes no progress.
+ */
+inline std::size_t write_at(int fd, std::span<const iovec> iov,
+                            std::uint64_t offset) {
+  // Partial writes trim the first pending vector, so work on a small window
+  // copy instead of the caller's array.
+  constexpr std::size_t window = IOV_MAX < 64 ? IOV_MAX : 64;
+  iovec pending[window];
+  std::size_t next = 0;  ///< First vector of `iov` not copied yet
+  std::size_t count = 0; ///< Vectors in `pending`
+  std::size_t first = 0; ///< First unfinished vector in `pending`
+  std::size_t done = 0;
+  while (true) {
+    if (first == count) {
+      count = std::min(window, iov.size() - next);
+      if (count == 0) {
+        return done;
+      }
+      std::copy_n(iov.begin() + next, count, pending);
+      next += count;
+      first = 0;
+    }
+    ssize_t n = ::pwritev(fd, pending + first, static_cast<int>(count - first),
+                          static_cast<off_t>(offset + done));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "write_at");
+    }
+    if (n == 0) {
+      // Bytes are pending; retrying would spin forever.
+      throw std::system_error(EIO, std::generic_category(),
+                              "write_at: no progress");
+    }
+    done += static_cast<std::size_t>(n);
+    auto left = static_cast<std::size_t>(n);
+    while (first < count && left >= pending[first].iov_len) {
+      left -= pending[first].iov_len;
+      ++first;
+    }
+    if (left > 0) {
+      auto *base = static_cast<std::byte *>(pending[first].iov_base);
+      pending[first].iov_base = base + left;
+      pending[first].iov_len -= left;
+    }
+  }
+}
+
+/// Writes every segment of `chain` with one gathering write per `IOV_MAX`
+template <typename T, std::size_t N>
+std::size_t write_at(int fd, const buffer_chain<T, N> &chain,
+                     std::uint64_t offset) {
+  return write_at(fd, chain.iovecs(), offset);
+}
+
+/// Writes the bytes of a single contiguous buffer
+inline std::size_t write_at(int fd, std::span<const std::byte> bytes,
+                            std::uint64_t offset) {
+  iovec iov{const_cast<std::byte *>(bytes.data()), bytes.size()};
+  return write_at(fd, std::span<const iovec>(&iov, 1), offset);
+}
+} // namespace nstd::memory::io
+
+#endif
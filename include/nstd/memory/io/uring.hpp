@@ -0,0 +1,517 @@
+#pragma once
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+
+#include "../concepts.h"
+#include "file_io.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <linux/io_uring.h>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace nstd::memory::io {
+namespace detail {
+/// A unique_buffer or shared_buffer, moved in or (if copyable) copied
+template <typename Buffer>
+concept ring_buffer =
+    concepts::SmartBuffer<std::remove_cvref_t<Buffer>,
+                          typename std::remove_cvref_t<Buffer>::value_type>;
+} // namespace detail
+
+/**
+ * What an asynchronous operation hands back once the kernel is done with the
+ * buffer.
+ */
+template <typename Buffer> struct completion {
+  Buffer buffer;  ///< The buffer that was submitted, owned by the caller again
+  int result = 0; ///< Bytes transferred, or -errno
+};
+
+/**
+ * @brief Minimal io_uring driver that keeps buffers alive while the kernel
+ * uses them.
+ *
+ * Reads and writes take a `unique_buffer` or `shared_buffer` (move it in).
+ * The ring owns the buffer from the moment the operation is queued until it
+ * completes, then hands it back through the callback or the future. Nothing
+ * can free or reuse the memory while the kernel may still touch it, and a
+ * call that throws leaves the buffer with the caller.
+ *
+ * Talks to the kernel through the raw `io_uring_setup` / `io_uring_enter` /
+ * `io_uring_register` syscalls, so liburing isn't required.
+ *
+ * Completions are only processed by `poll()`, `wait()` and `drain()`, on the
+ * calling thread. Futures are therefore fulfilled by those calls too. The
+ * ring is not thread-safe: drive it from one thread. Short reads and writes
+ * are reported as they are, not resubmitted.
+ *
+ * Fixed buffers: `register_pool()` registers a MemPool's whole slab once, so
+ * `read_fixed()` / `write_fixed()` (READ_FIXED / WRITE_FIXED) on blocks of that
+ * pool skip the per-operation page pinning.
+ */
+class uring {
+  /// Type-erased in-flight operation; its address is the SQE's user_data
+  struct operation_base {
+    virtual ~operation_base() = default;
+    virtual void complete(int result) = 0;
+  };
+
+  template <typename Buffer, typename Callback>
+  struct operation final : operation_base {
+    template <typename B>
+    operation(B &&b, Callback c)
+        : callback(std::move(c)), buffer(std::forward<B>(b)) {}
+
+    void complete(int result) override {
+      callback(std::move(buffer), result);
+    }
+
+    Callback callback; ///< First: a throwing move must not take the buffer
+    Buffer buffer;
+  };
+
+public:
+  /**
+   * @param entries Submission queue size (rounded up to a power of two by the
+   * kernel).
+   * @throws std::system_error if io_uring is unavailable or setup fails.
+   */
+  explicit uring(unsigned entries = 128) {
+    io_uring_params params{};
+    int fd =
+        static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "uring: io_uring_setup");
+    }
+    ring_ = file_descriptor(fd);
+    try {
+      map_rings(params);
+    } catch (...) {
+      unmap_rings();
+      throw;
+    }
+  }
+
+  uring(const uring &) = delete;
+  uring &operator=(const uring &) = delete;
+
+  /// Waits for every in-flight operation (running their callbacks) first.
+  ~uring() {
+    while (pending_ > 0) {
+      try {
+        wait(1);
+      } catch (const std::system_error &) {
+        break; /// The ring itself failed; nothing more will complete
+      } catch (...) {
+        /// Callbacks may throw; keep draining so no buffer is freed early
+      }
+    }
+    unmap_rings();
+  }
+
+  /// @return true if the running kernel allows io_uring
+  static bool supported() noexcept {
+    io_uring_params params{};
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, 1, &params));
+    if (fd < 0) {
+      return false;
+    }
+    ::close(fd);
+    return true;
+  }
+
+  /**
+   * @brief Queues a read of `buffer.size()` elements from `fd` at `offset`.
+   *
+   * Pass the buffer as an rvalue to hand it over (an lvalue shared_buffer is
+   * copied). The ring takes it only once the operation is queued: if this
+   * call throws, an rvalue buffer was not moved from and the caller still
+   * owns it.
+   *
+   * @param callback Invoked as `callback(std::move(buffer), result)` by the
+   * `poll()` / `wait()` call that reaps the completion.
+   *
+   * @throws std::invalid_argument if the buffer exceeds 4 GiB.
+   */
+  template <typename Buffer, typename Callback>
+    requires detail::ring_buffer<Buffer>
+  void read(int fd, Buffer &&buffer, std::uint64_t offset, Callback callback) {
+    queue(IORING_OP_READ, fd, std::forward<Buffer>(buffer), offset,
+          std::move(callback));
+  }
+
+  /// Queues a write of the whole buffer to `fd` at `offset`; see `read()`.
+  template <typename Buffer, typename Callback>
+    requires detail::ring_buffer<Buffer>
+  void write(int fd, Buffer &&buffer, std::uint64_t offset,
+             Callback callback) {
+    queue(IORING_OP_WRITE, fd, std::forward<Buffer>(buffer), offset,
+          std::move(callback));
+  }
+
+  /// Future-returning overload of `read()`
+  template <typename Buffer>
+    requires detail::ring_buffer<Buffer>
+  std::future<completion<std::remove_cvref_t<Buffer>>>
+  read(int fd, Buffer &&buffer, std::uint64_t offset) {
+    return queue_future(IORING_OP_READ, fd, std::forward<Buffer>(buffer),
+                        offset);
+  }
+
+  /// Future-returning overload of `write()`
+  template <typename Buffer>
+    requires detail::ring_buffer<Buffer>
+  std::future<completion<std::remove_cvref_t<Buffer>>>
+  write(int fd, Buffer &&buffer, std::uint64_t offset) {
+    return queue_future(IORING_OP_WRITE, fd, std::forward<Buffer>(buffer),
+                        offset);
+  }
+
+  /**
+   * @brief Like `read()`, with IORING_OP_READ_FIXED on a registered region.
+   * @throws std::invalid_argument if the buffer isn't inside a registered
+   * region (the buffer stays with the caller).
+   */
+  template <typename Buffer, typename Callback>
+    requires detail::ring_buffer<Buffer>
+  void read_fixed(int fd, Buffer &&buffer, std::uint64_t offset,
+                  Callback callback) {
+    queue(IORING_OP_READ_FIXED, fd, std::forward<Buffer>(buffer), offset,
+          std::move(callback));
+  }
+
+  /// Like `write()`, with IORING_OP_WRITE_FIXED; see `read_fixed()`.
+  template <typename Buffer, typename Callback>
+    requires detail::ring_buffer<Buffer>
+  void write_fixed(int fd, Buffer &&buffer, std::uint64_t offset,
+                   Callback callback) {
+    queue(IORING_OP_WRITE_FIXED, fd, std::forward<Buffer>(buffer), offset,
+          std::move(callback));
+  }
+
+  /// Future-returning overload of `read_fixed()`
+  template <typename Buffer>
+    requires detail::ring_buffer<Buffer>
+  std::future<completion<std::remove_cvref_t<Buffer>>>
+  read_fixed(int fd, Buffer &&buffer, std::uint64_t offset) {
+    return queue_future(IORING_OP_READ_FIXED, fd,
+                        std::forward<Buffer>(buffer), offset);
+  }
+
+  /// Future-returning overload of `write_fixed()`
+  template <typename Buffer>
+    requires detail::ring_buffer<Buffer>
+  std::future<completion<std::remove_cvref_t<Buffer>>>
+  write_fixed(int fd, Buffer &&buffer, std::uint64_t offset) {
+    return queue_future(IORING_OP_WRITE_FIXED, fd,
+                        std::forward<Buffer>(buffer), offset);
+  }
+
+  /**
+   * @brief Registers memory regions as fixed buffers, replacing any previous
+   * registration. Regions are pinned by the kernel (subject to
+   * RLIMIT_MEMLOCK) and limited to 1 GiB each.
+   * @throws std::system_error if the kernel refuses the registration.
+   */
+  void register_buffers(std::span<const iovec> regions) {
+    unregister_buffers();
+    if (regions.empty()) {
+      return;
+    }
+    if (::syscall(__NR_io_uring_register, ring_.get(), IORING_REGISTER_BUFFERS,
+                  regions.data(), static_cast<unsigned>(regions.size())) < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "uring: register buffers");
+    }
+    registered_.assign(regions.begin(), regions.end());
+  }
+
+  /// Registers the slab of a MemPool as fixed buffer 0
+  template <typename Pool>
+    requires requires(const Pool &pool) { pool.region(); }
+  void register_pool(const Pool &pool) {
+    std::span<std::byte> region = pool.region();
+    iovec iov{region.data(), region.size()};
+    register_buffers(std::span<const iovec>(&iov, 1));
+  }
+
+  /// Drops the fixed-buffer registration (if any)
+  void unregister_buffers() noexcept {
+    if (!registered_.empty()) {
+      ::syscall(__NR_io_uring_register, ring_.get(),
+                IORING_UNREGISTER_BUFFERS, nullptr, 0);
+      registered_.clear();
+    }
+  }
+
+  /**
+   * @brief Hands every queued operation to the kernel.
+   * @return The number of operations submitted.
+   * @throws std::system_error on failure.
+   */
+  std::size_t submit() { return enter(0, 0); }
+
+  /**
+   * @brief Submits queued operations and runs the callbacks of every
+   * completion already available, without blocking.
+   * @return The number of completions processed.
+   */
+  std::size_t poll() {
+    submit();
+    return reap();
+  }
+
+  /**
+   * @brief Submits queued operations, blocks until at least `count`
+   * completions are available, then processes every available completion.
+   * @return The number of completions processed.
+   */
+  std::size_t wait(std::size_t count = 1) {
+    count = std::min(count, pending_);
+    if (count > 0) {
+      enter(static_cast<unsigned>(count), IORING_ENTER_GETEVENTS);
+    }
+    return reap();
+  }
+
+  /// Waits for every queued and in-flight operation.
+  void drain() {
+    while (pending_ > 0) {
+      wait(pending_);
+    }
+  }
+
+  /// @return Operations queued or in flight whose completion wasn't reaped
+  std::size_t pending() const noexcept { return pending_; }
+
+private:
+  /**
+   * Everything that can fail (validation, waiting for a free SQE, allocating
+   * the operation) happens before the buffer is moved into the operation, and
+   * nothing can fail between that and committing the SQE.
+   */
+  template <typename Buffer, typename Callback>
+  void queue(std::uint8_t opcode, int fd, Buffer &&buffer,
+             std::uint64_t offset, Callback callback) {
+    using stored_type = std::remove_cvref_t<Buffer>;
+    using value_type = typename stored_type::value_type;
+    static_assert(std::is_trivially_copyable_v<value_type>,
+                  "uring: buffers must hold trivially copyable elements");
+    std::size_t bytes = buffer.size() * sizeof(value_type);
+    if (bytes > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::invalid_argument("uring: buffer exceeds 4 GiB");
+    }
+    auto *data = const_cast<std::byte *>(
+        reinterpret_cast<const std::byte *>(buffer.data()));
+    int index = -1;
+    if (opcode == IORING_OP_READ_FIXED || opcode == IORING_OP_WRITE_FIXED) {
+      index = registered_index(data, bytes);
+    }
+    // May run callbacks (which may queue); the slot is ours from here on.
+    io_uring_sqe *sqe = next_sqe();
+    auto op = std::make_unique<operation<stored_type, Callback>>(
+        std::forward<Buffer>(buffer), std::move(callback));
+
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<std::uint64_t>(data);
+    sqe->len = static_cast<std::uint32_t>(bytes);
+    if (index >= 0) {
+      sqe->buf_index = static_cast<std::uint16_t>(index);
+    }
+    operation_base *base = op.get();
+    sqe->user_data = reinterpret_cast<std::uint64_t>(base);
+    commit_sqe();
+    op.release();
+    ++pending_;
+  }
+
+  template <typename Buffer>
+  std::future<completion<std::remove_cvref_t<Buffer>>>
+  queue_future(std::uint8_t opcode, int fd, Buffer &&buffer,
+               std::uint64_t offset) {
+    using stored_type = std::remove_cvref_t<Buffer>;
+    std::promise<completion<stored_type>> promise;
+    auto future = promise.get_future();
+    queue(opcode, fd, std::forward<Buffer>(buffer), offset,
+          [promise = std::move(promise)](stored_type b, int result) mutable {
+            promise.set_value(completion<stored_type>{std::move(b), result});
+          });
+    return future;
+  }
+
+  /// @return The fixed-buffer index covering `[data, data + bytes)`
+  int registered_index(const std::byte *data, std::size_t bytes) const {
+    for (std::size_t i = 0; i < registered_.size(); ++i) {
+      const auto *base =
+          static_cast<const std::byte *>(registered_[i].iov_base);
+      if (data >= base && data + bytes <= base + registered_[i].iov_len) {
+        return static_cast<int>(i);
+      }
+    }
+    throw std::invalid_argument(
+        "uring: buffer is not inside a registered region");
+  }
+
+  /// @return A free SQE, submitting or reaping first when the rings are full
+  io_uring_sqe *next_sqe() {
+    while (true) {
+      unsigned head =
+          std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+      // Never have more operations out than the completion queue can hold.
+      if (sq_tail_ - head < sq_entries_ && pending_ < cq_entries_) {
+        return &sqes_[sq_tail_ & sq_mask_];
+      }
+      if (to_submit_ > 0 && sq_tail_ - head == sq_entries_) {
+        submit();
+      } else {
+        wait(1);
+      }
+    }
+  }
+
+  void commit_sqe() noexcept {
+    sq_array_[sq_tail_ & sq_mask_] = sq_tail_ & sq_mask_;
+    ++sq_tail_;
+    ++to_submit_;
+    std::atomic_ref(*sq_tail_ptr_).store(sq_tail_, std::memory_order_release);
+  }
+
+  std::size_t enter(unsigned min_complete, unsigned flags) {
+    while (true) {
+      long n = ::syscall(__NR_io_uring_enter, ring_.get(), to_submit_,
+                         min_complete, flags, nullptr, 0);
+      if (n >= 0) {
+        to_submit_ -= static_cast<unsigned>(n);
+        return static_cast<std::size_t>(n);
+      }
+      if (errno != EINTR) {
+        throw std::system_error(errno, std::generic_category(),
+                                "uring: io_uring_enter");
+      }
+    }
+  }
+
+  /// Runs the callback of every available completion
+  std::size_t reap() {
+    std::size_t reaped = 0;
+    while (true) {
+      unsigned head =
+          std::atomic_ref(*cq_head_).load(std::memory_order_relaxed);
+      unsigned tail =
+          std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+      if (head == tail) {
+        return reaped;
+      }
+      const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+      std::unique_ptr<operation_base> op(
+          reinterpret_cast<operation_base *>(cqe.user_data));
+      int result = cqe.res;
+      // Free the CQE slot before running user code, so a throwing callback
+      // leaves the ring consistent.
+      std::atomic_ref(*cq_head_).store(head + 1, std::memory_order_release);
+      --pending_;
+      ++reaped;
+      op->complete(result);
+    }
+  }
+
+  void map_rings(const io_uring_params &p) {
+    sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = single ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(map(sqes_size_, IORING_OFF_SQES));
+
+    auto *sq = static_cast<std::byte *>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned *>(sq + p.sq_off.head);
+    sq_tail_ptr_ = reinterpret_cast<unsigned *>(sq + p.sq_off.tail);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + p.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + p.sq_off.ring_mask);
+    sq_entries_ = p.sq_entries;
+    sq_tail_ = *sq_tail_ptr_;
+
+    auto *cq = static_cast<std::byte *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + p.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + p.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + p.cq_off.ring_mask);
+    cq_entries_ = p.cq_entries;
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + p.cq_off.cqes);
+  }
+
+  void *map(std::size_t size, std::uint64_t offset) {
+    void *ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_.get(),
+                       static_cast<off_t>(offset));
+    if (ptr == MAP_FAILED) {
+      throw std::system_error(errno, std::generic_category(), "uring: mmap");
+    }
+    return ptr;
+  }
+
+  void unmap_rings() noexcept {
+    if (sqes_) {
+      ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+      ::munmap(sq_ring_, sq_ring_size_);
+    }
+    sqes_ = nullptr;
+    sq_ring_ = cq_ring_ = nullptr;
+  }
+
+  file_descriptor ring_;
+  void *sq_ring_ = nullptr;
+  void *cq_ring_ = nullptr;
+  std::size_t sq_ring_size_ = 0;
+  std::size_t cq_ring_size_ = 0;
+  io_uring_sqe *sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+
+  unsigned *sq_head_ = nullptr;     ///< Advanced by the kernel
+  unsigned *sq_tail_ptr_ = nullptr; ///< Published by us
+  unsigned *sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned sq_tail_ = 0; ///< Local copy of the tail
+
+  unsigned *cq_head_ = nullptr; ///< Advanced by us
+  unsigned *cq_tail_ = nullptr; ///< Advanced by the kernel
+  io_uring_cqe *cqes_ = nullptr;
+  unsigned cq_mask_ = 0;
+  unsigned cq_entries_ = 0;
+
+  unsigned to_submit_ = 0;  ///< SQEs queued but not yet handed to the kernel
+  std::size_t pending_ = 0; ///< Operations whose completion wasn't reaped
+  std::vector<iovec> registered_;
+};
+} // namespace nstd::memory::io
+
+#endif
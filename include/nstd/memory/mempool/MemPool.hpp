@@ -1,13 +1,110 @@
 #pragma once
 
+#include "../numa.hpp"
+#include "../smart_buffers/shared_buffer.hpp"
 #include "../smart_buffers/unique_buffer.hpp"
+#include "hardening.hpp"
+#include "slab.hpp"
+#include "stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
+#include <exception>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 namespace nstd::memory {
+/**
+ * Order in which a MemPool hands released blocks out again.
+ */
+enum class RecyclingPolicy {
+  Lifo, /// Most recently released block first (warm caches)
+  Fifo, /// Never-used blocks first, then released blocks in release order
+  /// Fifo without locking, for exactly one acquiring and one releasing thread
+  SpscRing
+};
+
+/**
+ * @brief Construction-time tuning knobs for MemPool.
+ */
+struct MemPoolOptions {
+  /**
+   * Split the slab into one contiguous range per NUMA node, bind each range
+   * to its node before first touch, and serve `allocate()` from the caller's
+   * current node first. Degrades to the regular single-node layout when only
+   * one node is present.
+   */
+  bool numa_aware = false;
+
+  /**
+   * Preferred backing for the slab. Unavailable backings degrade towards
+   * `SlabBacking::Heap`; query `MemPool::backing()` for the one obtained.
+   */
+  SlabBacking backing = SlabBacking::Heap;
+
+  /// Fault every page of the slab in during construction.
+  bool populate = false;
+
+  /// mlock() the slab; query `MemPool::memory_locked()` for the outcome.
+  bool lock_memory = false;
+
+  /**
+   * Default-construct the elements of a block the first time it is handed
+   * out instead of constructing the whole slab up front. Only affects types
+   * that are not trivially default constructible.
+   */
+  bool lazy_construction = false;
+
+  /**
+   * Threads used to construct elements and pre-fault pages during pool
+   * construction (1 = constructing thread only).
+   */
+  std::size_t init_threads = 1;
+
+  /**
+   * Collect allocation/release counters and an acquire-latency histogram,
+   * readable through `MemPool::stats()`. Costs two clock reads and a few
+   * relaxed atomic increments per acquisition.
+   */
+  bool collect_stats = false;
+
+  /**
+   * Pad the block stride by one cache line whenever it would otherwise be a
+   * multiple of 4 KiB. Adjacent blocks then start at different page offsets,
+   * so streaming through two blocks at once (e.g. `dst[i] = f(src[i])`)
+   * doesn't stall on 4K aliasing between loads and stores. Costs one cache
+   * line per block in the affected geometries; query `MemPool::stride()`.
+   */
+  bool avoid_4k_aliasing = false;
+
+  /**
+   * In hardened builds (NSTD_MEMPOOL_HARDENED), overwrite released blocks of
+   * trivially copyable, trivially default constructible types with a poison
+   * pattern and verify it when the block is reused. Turn off when blocks
+   * must keep their contents across release (ObjectPool does).
+   */
+  bool poison_released = true;
+
+  /**
+   * How released blocks are reused. `Fifo` cycles through the slab in order,
+   * which keeps streaming (DMA-style) pipelines sequential. `SpscRing` does
+   * the same without taking the lock, provided that at any time at most one
+   * thread acquires and at most one thread releases blocks; it ignores
+   * `numa_aware`.
+   */
+  RecyclingPolicy recycling = RecyclingPolicy::Lifo;
+};
+
 /**
  * @brief A thread-safe, aligned memory pool that efficiently manages fixed-size
  * blocks.
@@ -16,24 +113,61 @@ namespace nstd::memory {
  * blocks. It ensures that each block is aligned to `Alignment` bytes, which is
  * critical for SIMD performance (e.g., AVX2/AVX512).
  *
+ * The immutable geometry read by `block_size()`, `capacity()`, `owns()` etc.
+ * and the mutable state written on every allocation live on separate cache
+ * lines, so lock traffic doesn't invalidate lines that lock-free readers on
+ * other cores are using.
+ *
  * @tparam T The type of elements in the pool.
  * @tparam Alignment The alignment requirement in bytes (default 64 for SIMD).
  */
-template <typename T, size_t Alignment = 64> class MemPool {
+template <typename T, size_t Alignment = 64>
+class alignas(64) MemPool {
 public:
+  /// Granularity at which the pool separates its hot and cold state
+  static constexpr std::size_t cache_line_size = 64;
+
+  /**
+   * @brief Pointer-sized deleter returning a block to its owning pool.
+   *
+   * Stored inline in the returned `unique_buffer`, so releasing a block is a
+   * direct (inlinable) call instead of a type-erased `std::function` call.
+   */
+  struct block_deleter {
+    MemPool *pool = nullptr;
+
+    void operator()(T *p) const noexcept { pool->release_block(p); }
+
+    /// Lets `shared_buffer(buffer_type&&)` use a pooled control block
+    shared_control_block *make_control_block(T *p) const {
+      return pool->share_block(p);
+    }
+  };
+
+  using buffer_type = unique_buffer<T, block_deleter>;
+
   /**
    * @brief Constructs the memory pool and pre-allocates all blocks.
    *
    * @param block_size The number of elements (T) in each block.
    * @param block_count The total number of blocks to allocate.
    * @param loc The metadata location tag (e.g., Host).
+   * @param options Additional construction options (see MemPoolOptions).
    *
    * @throws std::invalid_argument if size or count is 0.
    * @throws std::bad_alloc if memory allocation fails.
    */
   MemPool(std::size_t block_size, std::size_t block_count,
-          MemoryLocation loc = MemoryLocation::Host)
-      : block_size_(block_size), block_count_(block_count), location_(loc) {
+          MemoryLocation loc = MemoryLocation::Host,
+          MemPoolOptions options = {})
+      : block_size_(block_size), block_count_(block_count), location_(loc),
+        lazy_(options.lazy_construction &&
+              !std::is_trivially_default_constructible_v<T>),
+        poison_released_(options.poison_released),
+        policy_(options.recycling),
+        init_threads_(std::max<std::size_t>(options.init_threads, 1)),
+        counters_(options.collect_stats ? std::make_unique<pool_counters>()
+                                        : nullptr) {
     if (block_size_ == 0 || block_count_ == 0) {
       throw std::invalid_argument(
           "allocation_size and allocation_count must be > 0");
@@ -45,45 +179,125 @@ public:
     size_t byte_size = block_size_ * sizeof(T);
     size_t aligned_byte_size =
         (byte_size + Alignment - 1) / Alignment * Alignment;
+    if (options.avoid_4k_aliasing) {
+      // One cache line (rounded to the alignment) shifts every block to a new
+      // page offset; impossible when the alignment itself is >= 4 KiB.
+      constexpr size_t alias_period = 4096;
+      constexpr size_t pad =
+          (cache_line_size + Alignment - 1) / Alignment * Alignment;
+      if (pad < alias_period && aligned_byte_size % alias_period == 0) {
+        aligned_byte_size += pad;
+      }
+    }
     stride_ = aligned_byte_size / sizeof(T);
 
     size_t total_bytes = stride_ * sizeof(T) * block_count_;
+    size_t base_alignment = Alignment;
 
-    // Use C++17 aligned_alloc for base alignment.
-    void *ptr = std::aligned_alloc(Alignment, total_bytes);
-    if (!ptr) {
-      throw std::bad_alloc();
+    if (options.numa_aware && policy_ != RecyclingPolicy::SpscRing) {
+      node_count_ = std::min(numa::node_count(), block_count_);
+      // Online node ids may be sparse (e.g. 0 and 2); range i binds to the
+      // i-th online node.
+      const auto &online = numa::online_nodes();
+      node_ids_.assign(online.begin(), online.begin() + node_count_);
+    }
+    blocks_per_node_ = (block_count_ + node_count_ - 1) / node_count_;
+    if (node_count_ > 1) {
+      // Page-align the slab so node ranges can be bound independently.
+      base_alignment = std::max(base_alignment, numa::page_size());
+      total_bytes =
+          (total_bytes + base_alignment - 1) / base_alignment * base_alignment;
+    }
+
+    // Pages must not be faulted in before they are bound to their node, so
+    // a NUMA-split slab is populated by hand after binding. MAP_POPULATE is
+    // serial, so parallel initialization pre-faults by hand as well.
+    bool populate_on_map =
+        options.populate && node_count_ == 1 && init_threads_ == 1;
+    slab_ = slab(total_bytes, base_alignment, options.backing, populate_on_map,
+                 options.lock_memory);
+    data_ = static_cast<T *>(slab_.data());
+
+    // Bind node ranges before the construction below first-touches them.
+    if (node_count_ > 1) {
+      for (size_t node = 0; node < node_count_; ++node) {
+        size_t first = node * blocks_per_node_;
+        size_t last = std::min(first + blocks_per_node_, block_count_);
+        if (first < last) {
+          numa::bind_to_node(data_ + first * stride_,
+                             (last - first) * stride_ * sizeof(T),
+                             node_ids_[node]);
+        }
+      }
+    }
+    if (options.populate && !populate_on_map) {
+      std::size_t page = numa::page_size();
+      std::size_t pages = (slab_.size() + page - 1) / page;
+      for_each_chunk(pages, [this, page](size_t first, size_t last) {
+        slab_.prefault(first * page, (last - first) * page);
+      });
     }
-    data_ = static_cast<T *>(ptr);
 
     // Default construct elements if needed.
     // We use a try-catch block to ensure exception safety:
     // If a constructor throws, we must destroy previous blocks and free memory
     // because the MemPool destructor won't be called.
     if constexpr (!std::is_trivially_default_constructible_v<T>) {
-      size_t constructed_count = 0;
-      try {
-        for (size_t i = 0; i < block_count_; ++i) {
-          T *block_start = data_ + i * stride_;
-          std::uninitialized_default_construct(block_start,
-                                               block_start + block_size_);
-          constructed_count++;
-        }
-      } catch (...) {
-        // Rollback: destroy already constructed blocks
-        for (size_t i = 0; i < constructed_count; ++i) {
-          T *block_start = data_ + i * stride_;
-          std::destroy(block_start, block_start + block_size_);
+      if (!lazy_) {
+        auto errors = for_each_chunk(block_count_, [this](size_t first,
+                                                          size_t last) {
+          size_t constructed_count = first;
+          try {
+            for (; constructed_count < last; ++constructed_count) {
+              T *block_start = data_ + constructed_count * stride_;
+              std::uninitialized_default_construct(block_start,
+                                                   block_start + block_size_);
+            }
+          } catch (...) {
+            // Rollback: destroy the blocks this chunk already constructed
+            destroy_blocks(first, constructed_count);
+            throw;
+          }
+        });
+        for (size_t chunk = 0; chunk < errors.size(); ++chunk) {
+          if (errors[chunk]) {
+            // Rollback the chunks that did succeed, then report the failure.
+            // slab_ is a fully constructed member and frees itself on unwind.
+            for (size_t other = 0; other < errors.size(); ++other) {
+              if (!errors[other]) {
+                destroy_blocks(chunk_begin(other, block_count_, errors.size()),
+                               chunk_begin(other + 1, block_count_,
+                                           errors.size()));
+              }
+            }
+            std::rethrow_exception(errors[chunk]);
+          }
         }
-        std::free(data_);
-        throw;
       }
     }
 
-    // Initialize free list (LIFO for cache locality)
-    free_blocks_.reserve(block_count_);
-    for (std::size_t i = 0; i < block_count_; ++i) {
-      free_blocks_.push_back(data_ + i * stride_);
+    // Blocks are handed out from a per-node bump index and recycled through
+    // per-node free lists (a stack, or a ring in the FIFO policies), so setup
+    // does not touch every block. The free lists are sized up front so
+    // release never allocates.
+    live_.resize((block_count_ + 63) / 64);
+    nodes_.resize(node_count_);
+    for (std::size_t node = 0; node < node_count_; ++node) {
+      auto &blocks = nodes_[node];
+      blocks.next_fresh = std::min(node * blocks_per_node_, block_count_);
+      blocks.end = std::min(blocks.next_fresh + blocks_per_node_, block_count_);
+      if (policy_ == RecyclingPolicy::Lifo) {
+        blocks.free.reserve(blocks.end - blocks.next_fresh);
+      } else {
+        blocks.ring.resize(blocks.end - blocks.next_fresh);
+      }
+      if (lazy_) {
+        blocks.raw.reserve(blocks.end - blocks.next_fresh);
+      }
+    }
+    if constexpr (hardening::enabled) {
+      // Every block (and its padding) is off limits until handed out.
+      hardening::poison_region(data_, block_count_ * stride_ * sizeof(T));
     }
   }
 
@@ -91,45 +305,220 @@ public:
    * @brief Destructor. Destroys all elements and frees memory.
    *
    * @warning All `unique_buffer`s allocated from this pool MUST be destroyed
-   * before the pool itself. The pool does not track outstanding buffers.
+   * before the pool itself (see `drain()`), unless the pool was created with
+   * `create_shared()`. Check `stats().in_use` or `leak_report()` before
+   * destroying it; hardened builds report outstanding blocks on stderr.
    */
   ~MemPool() {
+    if constexpr (hardening::enabled) {
+      if (in_use_.load(std::memory_order_relaxed) != 0) {
+        try {
+          hardening::report(this, "destroyed with outstanding blocks",
+                            leak_report().c_str());
+        } catch (...) {
+          hardening::report(this, "destroyed with outstanding blocks", "");
+        }
+      }
+    }
     if (data_) {
+      if constexpr (hardening::enabled) {
+        hardening::unpoison_region(data_, block_count_ * stride_ * sizeof(T));
+      }
       if constexpr (!std::is_trivially_destructible_v<T>) {
-        for (size_t i = 0; i < block_count_; ++i) {
-          T *block_start = data_ + i * stride_;
-          std::destroy(block_start, block_start + block_size_);
+        if (!lazy_) {
+          destroy_blocks(0, block_count_);
+        } else {
+          // Only blocks handed out at least once were constructed, minus the
+          // ones whose lazy construction failed.
+          for (size_t node = 0; node < nodes_.size(); ++node) {
+            auto &blocks = nodes_[node];
+            std::sort(blocks.raw.begin(), blocks.raw.end());
+            size_t first = node * blocks_per_node_;
+            for (size_t i = first; i < blocks.next_fresh; ++i) {
+              T *block_start = data_ + i * stride_;
+              if (!std::binary_search(blocks.raw.begin(), blocks.raw.end(),
+                                      block_start)) {
+                std::destroy(block_start, block_start + block_size_);
+              }
+            }
+          }
         }
       }
-      std::free(data_);
     }
   }
 
   MemPool(const MemPool &) = delete;
   MemPool &operator=(const MemPool &) = delete;
 
+  /**
+   * @brief Creates a heap-allocated pool whose slab outlives its handle.
+   *
+   * When the last `shared_ptr` to the pool is dropped while blocks are still
+   * outstanding, the pool is not destroyed: it is destroyed (and the slab
+   * freed) when the last outstanding block is released instead. This makes
+   * shutdown order between the pool and its buffers irrelevant.
+   *
+   * Takes the same arguments as the constructor.
+   */
+  static std::shared_ptr<MemPool>
+  create_shared(std::size_t block_size, std::size_t block_count,
+                MemoryLocation loc = MemoryLocation::Host,
+                MemPoolOptions options = {}) {
+    return std::shared_ptr<MemPool>(
+        new MemPool(block_size, block_count, loc, options),
+        [](MemPool *pool) { pool->orphan(); });
+  }
+
   /**
    * @brief Allocates a unique_buffer from the pool.
    *
-   * @return A `unique_buffer<T>` with a custom deleter that returns memory to
-   * this pool.
+   * @return A `unique_buffer<T, block_deleter>` that returns memory to this
+   * pool. It converts implicitly to the type-erased `unique_buffer<T>`.
    *
    * @throws std::runtime_error if the pool is empty.
    *
    * @warning The returned buffer holds a reference to this pool. Ensure the
    * pool outlives the buffer!
    */
-  unique_buffer<T> allocate() {
-    std::lock_guard<std::mutex> lock(mtx_);
-    if (free_blocks_.empty()) {
+  buffer_type allocate() {
+    T *ptr = acquire_block();
+    if (!ptr) {
       throw std::runtime_error("MemPool: out of buffers");
     }
-    // LIFO (Stack) order: reuse mostly recently freed block for hot cache.
-    T *ptr = free_blocks_.back();
-    free_blocks_.pop_back();
+    return buffer_type(ptr, block_size_, block_deleter{this}, location_);
+  }
 
-    return unique_buffer<T>(
-        ptr, block_size_, [this](T *p) { this->release_block(p); }, location_);
+  /**
+   * @brief Allocates a block directly as a `shared_buffer`.
+   *
+   * The control block comes from a free list of slots owned by the pool
+   * (created on the first call) and goes back to it together with the block
+   * when the last owner drops. Sharing a pooled block therefore never touches
+   * the global heap. Converting a `buffer_type` from `allocate()` into a
+   * `shared_buffer` does the same; only the type-erased `unique_buffer<T>`
+   * gets a heap-allocated control block.
+   *
+   * A `weak_buffer` observing the result keeps only the slot out once the
+   * block is back in the pool. If every slot is held that way, the free list
+   * grows by one slot, kept until the pool is destroyed.
+   *
+   * @tparam RefCount `local_refcount` for buffers that stay on the calling
+   * thread (see `local_shared_buffer`).
+   *
+   * @throws std::runtime_error if the pool is empty.
+   * @throws std::bad_alloc if the slot list cannot grow.
+   *
+   * @warning Same lifetime rules as `allocate()`, which extend to the
+   * `weak_buffer`s of the result.
+   */
+  template <typename RefCount = atomic_refcount>
+  shared_buffer<T, RefCount> allocate_shared() {
+    std::call_once(slots_once_, [this] { init_shared_slots(); });
+    shared_slot *slot = nullptr;
+    T *ptr = acquire(&slot);
+    if (!ptr) {
+      throw std::runtime_error("MemPool: out of buffers");
+    }
+    if (!slot) {
+      // Every slot is taken: weak_buffers keep some alive past their block.
+      try {
+        std::lock_guard<std::mutex> lock(mtx_);
+        slot = grow_slots();
+      } catch (...) {
+        release(ptr, nullptr);
+        throw;
+      }
+    }
+    return shared_buffer<T, RefCount>(reset_slot(slot, ptr), ptr,
+                                      block_size_);
+  }
+
+  /**
+   * @brief Low-level: pops a raw block off the free list.
+   *
+   * Intended for adapters that build their own ownership on top of the pool
+   * (e.g. SizeClassPool). Every acquired block must be handed back through
+   * `release_block()`. Prefer `allocate()`.
+   *
+   * @return A pointer to `block_size()` elements, or nullptr if the pool is
+   * exhausted.
+   *
+   * @throws Whatever T's default constructor throws when lazy construction is
+   * enabled; the block stays in the pool.
+   */
+  T *acquire_block() noexcept(std::is_nothrow_default_constructible_v<T>) {
+    return acquire(nullptr);
+  }
+
+  /**
+   * @brief Returns a block to the free list. Called by the block_deleter, or
+   * directly by users of `acquire_block()`.
+   */
+  void release_block(T *p) noexcept { release(p, nullptr); }
+
+  /**
+   * @brief Blocks until every outstanding block has been released.
+   *
+   * Use before destroying the pool to make sure no buffer still refers to it.
+   */
+  void drain() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    ++drain_waiters_;
+    drained_.wait(lock, [this] {
+      return in_use_.load(std::memory_order_relaxed) == 0;
+    });
+    --drain_waiters_;
+  }
+
+  /**
+   * @brief Like `drain()`, but gives up after `timeout`.
+   *
+   * @return true if all blocks were released in time.
+   */
+  template <typename Rep, typename Period>
+  bool drain_for(const std::chrono::duration<Rep, Period> &timeout) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    ++drain_waiters_;
+    bool drained = drained_.wait_for(lock, timeout, [this] {
+      return in_use_.load(std::memory_order_relaxed) == 0;
+    });
+    --drain_waiters_;
+    return drained;
+  }
+
+  /**
+   * @return Indices (in slab order) of the blocks currently handed out.
+   */
+  std::vector<std::size_t> outstanding_blocks() const {
+    std::vector<std::size_t> indices;
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (std::size_t word = 0; word < live_.size(); ++word) {
+      for (std::uint64_t bits = live_word(word); bits != 0;
+           bits &= bits - 1) {
+        indices.push_back(word * 64 +
+                          static_cast<std::size_t>(std::countr_zero(bits)));
+      }
+    }
+    return indices;
+  }
+
+  /**
+   * @return Human readable list of outstanding blocks, or an empty string if
+   * there are none.
+   */
+  std::string leak_report() const {
+    auto indices = outstanding_blocks();
+    if (indices.empty()) {
+      return {};
+    }
+    std::string report = "MemPool: " + std::to_string(indices.size()) +
+                         " outstanding block(s):";
+    for (std::size_t index : indices) {
+      report += "\n  block " + std::to_string(index) + " (element offset " +
+                std::to_string(index * stride_) + ")";
+    }
+    report += "\n";
+    return report;
   }
 
   /// @return number of elements in each block
@@ -138,27 +527,666 @@ public:
   /// @return total number of blocks in the pool
   std::size_t capacity() const noexcept { return block_count_; }
 
-  /// @return number of currently available blocks
+  /// @return the order in which released blocks are reused
+  RecyclingPolicy recycling() const noexcept { return policy_; }
+
+  /// @return distance in elements between the starts of consecutive blocks
+  std::size_t stride() const noexcept { return stride_; }
+
+  /// @return number of currently available blocks (lock-free; may lag
+  /// concurrent allocations)
   std::size_t available() const noexcept {
-    std::lock_guard<std::mutex> lock(mtx_);
-    return free_blocks_.size();
+    return block_count_ - in_use_.load(std::memory_order_relaxed);
+  }
+
+  /// @return true if the pool was constructed with `collect_stats`
+  bool stats_enabled() const noexcept { return counters_ != nullptr; }
+
+  /**
+   * @brief Lock-free snapshot of the pool's counters.
+   *
+   * Cheap enough to scrape from a metrics thread without disturbing the
+   * allocation path. Without `collect_stats` only `in_use` is populated.
+   */
+  MemPoolStats stats() const noexcept {
+    std::uint64_t in_use = in_use_.load(std::memory_order_relaxed);
+    if (!counters_) {
+      MemPoolStats stats;
+      stats.in_use = in_use;
+      return stats;
+    }
+    return counters_->snapshot(in_use);
+  }
+
+  /// @return the slab backing actually obtained (see MemPoolOptions::backing)
+  SlabBacking backing() const noexcept { return slab_.backing(); }
+
+  /// @return true if the slab is locked into RAM
+  bool memory_locked() const noexcept { return slab_.locked(); }
+
+  /**
+   * @return The slab region holding every block, e.g. to register it once
+   * with the kernel (io_uring fixed buffers) instead of per block.
+   */
+  std::span<std::byte> region() const noexcept {
+    return {reinterpret_cast<std::byte *>(data_),
+            block_count_ * stride_ * sizeof(T)};
+  }
+
+  /// @return true if `p` points into this pool's slab
+  bool owns(const T *p) const noexcept {
+    auto addr = reinterpret_cast<std::uintptr_t>(p);
+    auto begin = reinterpret_cast<std::uintptr_t>(data_);
+    return addr >= begin && addr < begin + block_count_ * stride_ * sizeof(T);
+  }
+
+  /// @return number of NUMA nodes the slab is split across (1 if not NUMA
+  /// aware or on a single-node system)
+  std::size_t node_count() const noexcept { return node_count_; }
+
+  /// @return the id of the NUMA node whose slab range holds block `p` (0 if
+  /// the slab is not split)
+  std::size_t node_of(const T *p) const noexcept {
+    return node_count_ > 1 ? node_ids_[range_of(p)] : 0;
   }
 
 private:
   /**
-   * @brief Returns a block to the free list. Called by unique_buffer deleter.
+   * Blocks of one NUMA node's slab range. Never-used blocks are taken from
+   * `[next_fresh, end)`; returned blocks go to `free`.
    */
-  void release_block(T *p) {
+  struct node_blocks {
+    std::vector<T *> free; ///< Lifo: stack of recycled (constructed) blocks
+    std::vector<T *> raw;  ///< Fresh blocks whose lazy construction failed
+    std::size_t next_fresh = 0; ///< Index of the next never-used block
+    std::size_t end = 0;        ///< One past the node's last block index
+    /// Fifo/SpscRing: circular queue of recycled blocks, one slot per block
+    std::vector<T *> ring;
+    std::size_t ring_head = 0; ///< Fifo: position of the oldest entry
+    std::size_t ring_size = 0; ///< Fifo: number of queued entries
+  };
+
+  /// Control block of a block handed out by `allocate_shared()`
+  struct shared_slot : shared_control_block {
+    MemPool *pool = nullptr;
+    T *block = nullptr;
+
+    static void destroy_slot(shared_control_block *base,
+                             DestroyScope scope) noexcept {
+      auto *slot = static_cast<shared_slot *>(base);
+      switch (scope) {
+      case DestroyScope::All:
+        slot->pool->release(slot->block, slot);
+        break;
+      case DestroyScope::Data:
+        // weak_buffers still refer to the slot: detach it from its block.
+        slot->pool->release(slot->block, nullptr, true);
+        break;
+      case DestroyScope::Block:
+        slot->pool->release_slot(slot);
+        break;
+      }
+    }
+  };
+
+  /**
+   * Shared implementation of `acquire_block()` and `allocate_shared()`. When
+   * `slot` is given, a control-block slot is popped under the same lock.
+   */
+  T *acquire(shared_slot **slot) noexcept(
+      std::is_nothrow_default_constructible_v<T>) {
+    using clock = pool_counters::clock;
+    clock::time_point start;
+    clock::time_point locked;
+    if (counters_) {
+      start = clock::now();
+    }
+
+    size_t home = node_count_ > 1 ? home_range() : 0;
+    T *ptr = nullptr;
+    bool fresh = false;
+    [[maybe_unused]] bool recycled = false;
+    bool local = true;
+    std::size_t in_use = 0;
+    if (policy_ == RecyclingPolicy::SpscRing) {
+      // Lock-free: this is the only acquiring thread, so the bump index, the
+      // raw list and the ring head are ours.
+      if (counters_) {
+        locked = start;
+      }
+      ptr = take_block(nodes_[0], fresh, recycled);
+      if (ptr) {
+        in_use = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+        mark_live(ptr, true);
+        if (slot) {
+          std::lock_guard<std::mutex> lock(mtx_);
+          *slot = pop_slot();
+        }
+      }
+    } else {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (counters_) {
+        locked = clock::now();
+      }
+      // Prefer the caller's node, then steal from the others in order.
+      for (size_t i = 0; i < node_count_ && !ptr; ++i) {
+        local = i == 0;
+        ptr = take_block(nodes_[(home + i) % node_count_], fresh, recycled);
+      }
+      if (ptr) {
+        // Only ever written under the lock; atomic so readers need none.
+        in_use = in_use_.load(std::memory_order_relaxed) + 1;
+        in_use_.store(in_use, std::memory_order_relaxed);
+        mark_live(ptr, true);
+        if (slot) {
+          *slot = pop_slot();
+        }
+      }
+    }
+    if (!ptr) {
+      if (counters_) {
+        counters_->record_failure(start, locked);
+      }
+      return nullptr;
+    }
+    if constexpr (hardening::enabled) {
+      check_acquired(ptr, recycled);
+    }
+    if constexpr (!std::is_trivially_default_constructible_v<T>) {
+      // Construct outside the lock so expensive constructors don't serialize
+      // other threads.
+      if (fresh && lazy_) {
+        if constexpr (std::is_nothrow_default_constructible_v<T>) {
+          std::uninitialized_default_construct(ptr, ptr + block_size_);
+        } else {
+          try {
+            std::uninitialized_default_construct(ptr, ptr + block_size_);
+          } catch (...) {
+            void (*finalize)(MemPool *) = nullptr;
+            {
+              std::lock_guard<std::mutex> lock(mtx_);
+              nodes_[range_of(ptr)].raw.push_back(ptr);
+              mark_live(ptr, false);
+              if (slot && *slot) {
+                free_slots_.push_back(*slot);
+              }
+              if (in_use_.fetch_sub(1, std::memory_order_relaxed) == 1) {
+                if (drain_waiters_ > 0) {
+                  drained_.notify_all();
+                }
+                if (detached_slots_ == 0) {
+                  finalize = finalize_orphan_;
+                }
+              }
+            }
+            if (finalize) {
+              finalize(this);
+            }
+            throw;
+          }
+        }
+      }
+    } else {
+      (void)fresh;
+    }
+    if (counters_) {
+      counters_->record_acquire(start, locked, clock::now(), local, in_use);
+    }
+    return ptr;
+  }
+
+  /**
+   * Returns block `p` and, if given, its control-block slot. With
+   * `detach_slot`, the block's slot stays out (observed by weak_buffers) and
+   * keeps the pool alive until `release_slot()`.
+   */
+  void release(T *p, shared_slot *slot, bool detach_slot = false) noexcept {
+    if constexpr (hardening::enabled) {
+      check_released(p);
+    }
+    // SpscRing: only the release that brings in_use_ to zero (and thereby
+    // lets a drained or orphaned pool be destroyed) needs the lock. A failed
+    // lazy construction in acquire() also decrements in_use_, so the
+    // decrement is claimed with a CAS that never takes it from 1 to 0; if it
+    // would, the release finishes on the locked path below.
+    bool returned = false;
+    if (policy_ == RecyclingPolicy::SpscRing && !slot && !detach_slot &&
+        in_use_.load(std::memory_order_relaxed) > 1) {
+      if constexpr (hardening::enabled) {
+        if (!is_live(p)) {
+          hardening::fail(this, "double release", p);
+        }
+        poison_block(p);
+      }
+      mark_live(p, false);
+      push_block(nodes_[0], p);
+      if (counters_) {
+        counters_->record_release();
+      }
+      returned = true;
+      std::size_t in_use = in_use_.load(std::memory_order_relaxed);
+      while (in_use > 1 &&
+             !in_use_.compare_exchange_weak(in_use, in_use - 1,
+                                            std::memory_order_relaxed)) {
+      }
+      if (in_use > 1) {
+        return;
+      }
+    }
+    size_t node = range_of(p);
+    void (*finalize)(MemPool *) = nullptr;
+    {
+      // Once the lock is dropped a drained (or orphaned) pool may be
+      // destroyed by another thread, so all bookkeeping happens under it.
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (!returned) {
+        if constexpr (hardening::enabled) {
+          if (!is_live(p)) {
+            hardening::fail(this, "double release", p);
+          }
+          poison_block(p);
+        }
+        mark_live(p, false);
+        push_block(nodes_[node], p);
+        if (counters_) {
+          counters_->record_release();
+        }
+      }
+      if (slot) {
+        free_slots_.push_back(slot);
+      }
+      if (detach_slot) {
+        ++detached_slots_;
+      }
+      std::size_t in_use;
+      if (policy_ == RecyclingPolicy::SpscRing) {
+        in_use = in_use_.fetch_sub(1, std::memory_order_relaxed) - 1;
+      } else {
+        in_use = in_use_.load(std::memory_order_relaxed) - 1;
+        in_use_.store(in_use, std::memory_order_relaxed);
+      }
+      if (in_use == 0 && drain_waiters_ > 0) {
+        drained_.notify_all();
+      }
+      if (in_use == 0 && detached_slots_ == 0) {
+        finalize = finalize_orphan_;
+      }
+    }
+    if (finalize) {
+      finalize(this); // Last block of a pool whose owner is already gone
+    }
+  }
+
+  /// Returns a slot detached by `release()` once no weak_buffer observes it.
+  void release_slot(shared_slot *slot) noexcept {
+    void (*finalize)(MemPool *) = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      free_slots_.push_back(slot);
+      if (--detached_slots_ == 0 &&
+          in_use_.load(std::memory_order_relaxed) == 0) {
+        finalize = finalize_orphan_;
+      }
+    }
+    if (finalize) {
+      finalize(this);
+    }
+  }
+
+  /**
+   * Take a block from `blocks` according to the recycling policy. Caller
+   * holds `mtx_`, or is the single SpscRing acquirer.
+   */
+  T *take_block(node_blocks &blocks, bool &fresh, bool &recycled) noexcept {
+    if (!blocks.raw.empty()) {
+      T *ptr = blocks.raw.back();
+      blocks.raw.pop_back();
+      fresh = true;
+      return ptr;
+    }
+    if (policy_ == RecyclingPolicy::Lifo && !blocks.free.empty()) {
+      // LIFO (Stack) order: reuse mostly recently freed block for hot cache.
+      T *ptr = blocks.free.back();
+      blocks.free.pop_back();
+      recycled = true;
+      return ptr;
+    }
+    if (blocks.next_fresh < blocks.end) {
+      fresh = true;
+      return data_ + blocks.next_fresh++ * stride_;
+    }
+    if (policy_ == RecyclingPolicy::Fifo && blocks.ring_size > 0) {
+      T *ptr = blocks.ring[blocks.ring_head];
+      blocks.ring_head = (blocks.ring_head + 1) % blocks.ring.size();
+      --blocks.ring_size;
+      recycled = true;
+      return ptr;
+    }
+    if (policy_ == RecyclingPolicy::SpscRing) {
+      std::size_t head = ring_head_.load(std::memory_order_relaxed);
+      if (head != ring_tail_.load(std::memory_order_acquire)) {
+        T *ptr = blocks.ring[head % blocks.ring.size()];
+        ring_head_.store(head + 1, std::memory_order_relaxed);
+        recycled = true;
+        return ptr;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Queue a released block according to the recycling policy. Caller holds
+   * `mtx_`, or is the single SpscRing releaser.
+   */
+  void push_block(node_blocks &blocks, T *p) noexcept {
+    switch (policy_) {
+    case RecyclingPolicy::Lifo:
+      blocks.free.push_back(p);
+      break;
+    case RecyclingPolicy::Fifo:
+      blocks.ring[(blocks.ring_head + blocks.ring_size) % blocks.ring.size()] =
+          p;
+      ++blocks.ring_size;
+      break;
+    case RecyclingPolicy::SpscRing: {
+      // The ring has a slot for every block, so it can't be full; the slot
+      // written here was consumed before the block being released was
+      // handed to this thread.
+      std::size_t tail = ring_tail_.load(std::memory_order_relaxed);
+      blocks.ring[tail % blocks.ring.size()] = p;
+      ring_tail_.store(tail + 1, std::memory_order_release);
+      break;
+    }
+    }
+  }
+
+  /// Pop a control-block slot, or nullptr if none is left. Caller holds
+  /// `mtx_`.
+  shared_slot *pop_slot() noexcept {
+    // One slot per block, so a slot is free for every block unless detached
+    // slots are held by weak_buffers.
+    if (free_slots_.empty()) {
+      return nullptr;
+    }
+    shared_slot *slot = free_slots_.back();
+    free_slots_.pop_back();
+    return slot;
+  }
+
+  /**
+   * Add a slot beyond the one per block, for when weak_buffers hold detached
+   * slots. Reserves room in `free_slots_` so releases never allocate. Caller
+   * holds `mtx_`.
+   */
+  shared_slot *grow_slots() {
+    free_slots_.reserve(block_count_ + extra_slots_.size() + 1);
+    extra_slots_.push_back(std::make_unique<shared_slot>());
+    shared_slot *slot = extra_slots_.back().get();
+    slot->pool = this;
+    slot->location = location_;
+    slot->destroy = &shared_slot::destroy_slot;
+    return slot;
+  }
+
+  /// Prepare a recycled slot to own `block` through a fresh shared_buffer.
+  static shared_slot *reset_slot(shared_slot *slot, T *block) noexcept {
+    slot->ref.store(1, std::memory_order_relaxed);
+    slot->weak.store(1, std::memory_order_relaxed);
+    slot->cross_thread.store(false, std::memory_order_relaxed);
+    slot->block = block;
+    return slot;
+  }
+
+  /// Control block for a block handed out by `allocate()`; see block_deleter.
+  shared_control_block *share_block(T *block) {
+    std::call_once(slots_once_, [this] { init_shared_slots(); });
+    shared_slot *slot;
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      slot = pop_slot();
+      if (!slot) {
+        slot = grow_slots();
+      }
+    }
+    return reset_slot(slot, block);
+  }
+
+  /// Create the control-block slots, one per block.
+  void init_shared_slots() {
+    slots_ = std::make_unique<shared_slot[]>(block_count_);
     std::lock_guard<std::mutex> lock(mtx_);
-    free_blocks_.push_back(p);
+    free_slots_.reserve(block_count_);
+    for (std::size_t i = block_count_; i-- > 0;) {
+      slots_[i].pool = this;
+      slots_[i].location = location_;
+      slots_[i].destroy = &shared_slot::destroy_slot;
+      free_slots_.push_back(&slots_[i]);
+    }
   }
 
+
+  /**
+   * Called when the last `create_shared()` handle is dropped: destroy now if
+   * idle, otherwise let the last `release_block()` do it.
+   */
+  void orphan() noexcept {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (in_use_.load(std::memory_order_relaxed) != 0 ||
+          detached_slots_ != 0) {
+        finalize_orphan_ = [](MemPool *pool) { delete pool; };
+        return;
+      }
+    }
+    delete this;
+  }
+
+  /**
+   * Flip the live bit of block `p`. Caller holds `mtx_`, except under
+   * SpscRing where acquirer and releaser update the words atomically.
+   */
+  void mark_live(const T *p, bool live) noexcept {
+    auto index = static_cast<std::size_t>(p - data_) / stride_;
+    std::uint64_t bit = std::uint64_t{1} << (index % 64);
+    if (policy_ == RecyclingPolicy::SpscRing) {
+      std::atomic_ref<std::uint64_t> word(live_[index / 64]);
+      if (live) {
+        word.fetch_or(bit, std::memory_order_relaxed);
+      } else {
+        word.fetch_and(~bit, std::memory_order_relaxed);
+      }
+    } else if (live) {
+      live_[index / 64] |= bit;
+    } else {
+      live_[index / 64] &= ~bit;
+    }
+  }
+
+  /// Read one word of the live bitmap (atomically, see `mark_live()`).
+  std::uint64_t live_word(std::size_t word) const noexcept {
+    // atomic_ref needs a mutable referent; the load doesn't modify it.
+    return std::atomic_ref<std::uint64_t>(
+               const_cast<std::uint64_t &>(live_[word]))
+        .load(std::memory_order_relaxed);
+  }
+
+  /// @return true if block `p` is currently handed out
+  bool is_live(const T *p) const noexcept {
+    auto index = static_cast<std::size_t>(p - data_) / stride_;
+    return (live_word(index / 64) >> (index % 64)) & 1;
+  }
+
+  /// Blocks whose bytes may be overwritten while they sit in the free list
+  static constexpr bool byte_poisonable =
+      std::is_trivially_copyable_v<T> &&
+      std::is_trivially_default_constructible_v<T>;
+
+  /**
+   * Hardened mode: make a block that is being handed out accessible, verify
+   * nobody wrote to it while it was free and arm its padding canary.
+   */
+  void check_acquired(T *p, bool recycled) noexcept {
+    auto *bytes = reinterpret_cast<unsigned char *>(p);
+    std::size_t len = block_size_ * sizeof(T);
+    hardening::unpoison_region(bytes, len);
+    if constexpr (byte_poisonable) {
+      if (recycled && poison_released_ &&
+          !hardening::intact(bytes, len, hardening::poison_byte)) {
+        hardening::fail(this, "block written after release", p);
+      }
+    }
+    if constexpr (!hardening::asan) {
+      // Under ASan the padding stays poisoned, which catches overruns on the
+      // spot instead of at release.
+      hardening::fill(bytes + len, (stride_ - block_size_) * sizeof(T),
+                      hardening::canary_byte);
+    }
+  }
+
+  /**
+   * Hardened mode: reject pointers this pool never handed out and blocks
+   * whose padding canary was overwritten.
+   */
+  void check_released(const T *p) const noexcept {
+    if (!owns(p)) {
+      hardening::fail(this, "released pointer not owned by this pool", p);
+    }
+    auto offset = reinterpret_cast<std::uintptr_t>(p) -
+                  reinterpret_cast<std::uintptr_t>(data_);
+    if (offset % (stride_ * sizeof(T)) != 0) {
+      hardening::fail(this, "released pointer not at a block boundary", p);
+    }
+    if constexpr (!hardening::asan) {
+      const auto *bytes = reinterpret_cast<const unsigned char *>(p);
+      if (!hardening::intact(bytes + block_size_ * sizeof(T),
+                             (stride_ - block_size_) * sizeof(T),
+                             hardening::canary_byte)) {
+        hardening::fail(this, "block overrun (padding canary overwritten)",
+                        p);
+      }
+    }
+  }
+
+  /// Hardened mode: poison a block entering the free list. Caller holds mtx_.
+  void poison_block(T *p) noexcept {
+    if constexpr (byte_poisonable) {
+      if (poison_released_) {
+        hardening::fill(p, block_size_ * sizeof(T), hardening::poison_byte);
+      }
+    }
+    hardening::poison_region(p, stride_ * sizeof(T));
+  }
+
+  std::size_t node_of_index(std::size_t index) const noexcept {
+    return std::min(index / blocks_per_node_, node_count_ - 1);
+  }
+
+  /// @return index into nodes_ of the slab range holding block `p`
+  std::size_t range_of(const T *p) const noexcept {
+    return node_of_index(static_cast<std::size_t>(p - data_) / stride_);
+  }
+
+  /**
+   * @return index into nodes_ of the calling thread's node. Uses the per-thread
+   * cached node, so no syscall on the acquire path. Threads on a node without
+   * a range of their own spread over the ranges by node id.
+   */
+  std::size_t home_range() const noexcept {
+    std::size_t node = numa::cached_current_node();
+    for (std::size_t i = 0; i < node_count_; ++i) {
+      if (node_ids_[i] == node) {
+        return i;
+      }
+    }
+    return node % node_count_;
+  }
+
+  void destroy_blocks(std::size_t first, std::size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+      T *block_start = data_ + i * stride_;
+      std::destroy(block_start, block_start + block_size_);
+    }
+  }
+
+  static std::size_t chunk_begin(std::size_t chunk, std::size_t count,
+                                 std::size_t chunks) noexcept {
+    return count * chunk / chunks;
+  }
+
+  /**
+   * Split `[0, count)` into `init_threads_` chunks and run `fn(first, last)`
+   * on each, the first chunk on the calling thread.
+   *
+   * @return One entry per chunk holding the exception it threw, if any.
+   */
+  template <typename Fn>
+  std::vector<std::exception_ptr> for_each_chunk(std::size_t count, Fn fn) {
+    std::size_t chunks = std::max<std::size_t>(
+        std::min(init_threads_, count), 1);
+    std::vector<std::exception_ptr> errors(chunks);
+    auto run = [&](std::size_t chunk) {
+      try {
+        fn(chunk_begin(chunk, count, chunks),
+           chunk_begin(chunk + 1, count, chunks));
+      } catch (...) {
+        errors[chunk] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+      try {
+        workers.emplace_back(run, chunk);
+      } catch (const std::system_error &) {
+        run(chunk); // Could not spawn a thread: do the work here instead
+      }
+    }
+    run(0);
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    return errors;
+  }
+
+  // Immutable after construction. Grouped at the front of the (cache-line
+  // aligned) object so lock-free readers never share a line with the lock.
   std::size_t block_size_;
   std::size_t stride_; ///< Stride in elements (includes padding for alignment)
   std::size_t block_count_;
   MemoryLocation location_;
-  T *data_ = nullptr; ///< Pointer to the single contiguous memory chunk
-  std::vector<T *> free_blocks_; ///< Stack of free block pointers
-  mutable std::mutex mtx_;
+  bool lazy_;                ///< Construct blocks on first acquisition
+  bool poison_released_;     ///< Hardened mode: pattern-fill released blocks
+  RecyclingPolicy policy_;   ///< Order in which free blocks are reused
+  std::size_t init_threads_; ///< Threads used during construction
+  std::size_t node_count_ = 1;      ///< NUMA nodes the slab is split across
+  std::size_t blocks_per_node_ = 0; ///< Blocks in each node's slab range
+  std::vector<std::size_t> node_ids_; ///< NUMA node id of each slab range
+  std::unique_ptr<pool_counters> counters_; ///< Null unless collect_stats
+  slab slab_;         ///< Owner of the single contiguous memory chunk
+  T *data_ = nullptr; ///< Typed start of slab_
+  std::unique_ptr<shared_slot[]> slots_; ///< allocate_shared() control blocks
+  std::once_flag slots_once_;
+
+  // Mutable state, written under mtx_ on every acquire/release. Starts on a
+  // fresh cache line; the class alignment pads the tail of the object so it
+  // doesn't share a line with whatever follows the pool in memory either.
+  alignas(cache_line_size) mutable std::mutex mtx_;
+  std::atomic<std::size_t> in_use_{0}; ///< Blocks currently handed out
+  std::vector<node_blocks> nodes_; ///< Per-node block bookkeeping
+  std::vector<std::uint64_t> live_; ///< One bit per block, set while out
+  std::size_t drain_waiters_ = 0;   ///< Threads blocked in drain()
+  /// Set once the create_shared() handle is gone while blocks are still out;
+  /// the last release_block() calls it to destroy the pool.
+  void (*finalize_orphan_)(MemPool *) = nullptr;
+  std::condition_variable drained_; ///< Signalled when in_use_ drops to 0
+  /// Slots beyond `slots_`, added by `grow_slots()`
+  std::vector<std::unique_ptr<shared_slot>> extra_slots_;
+  std::vector<shared_slot *> free_slots_; ///< Unused slots
+  std::size_t detached_slots_ = 0; ///< Slots held only by weak_buffers
+
+  // SpscRing positions, each written by one side only and kept on its own
+  // cache line so acquirer and releaser don't false-share.
+  alignas(cache_line_size) std::atomic<std::size_t> ring_head_{0};
+  alignas(cache_line_size) std::atomic<std::size_t> ring_tail_{0};
 };
 } // namespace nstd::memory
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "MemPool.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace nstd::memory {
+/**
+ * @brief A `std::pmr::memory_resource` serving node-sized requests from a
+ * MemPool.
+ *
+ * Requests of at most `block_bytes` bytes (and alignment at most `Alignment`)
+ * are served from pool blocks; larger requests, over-aligned requests and
+ * requests made while the pool is exhausted go to the upstream resource. This
+ * makes it a drop-in backing store for `std::pmr` node-based containers
+ * (`std::pmr::list`, `std::pmr::unordered_map`, ...).
+ *
+ * @tparam Alignment Alignment of every pool block in bytes.
+ */
+template <size_t Alignment = 64>
+class MemPoolResource : public std::pmr::memory_resource {
+public:
+  using pool_type = MemPool<std::byte, Alignment>;
+
+  /**
+   * @param block_bytes Largest request (in bytes) served from the pool.
+   * @param block_count Number of pool blocks.
+   * @param upstream Resource for requests the pool cannot serve.
+   * @param options Options forwarded to the MemPool.
+   *
+   * @throws std::invalid_argument if block_bytes or block_count is 0.
+   */
+  MemPoolResource(
+      std::size_t block_bytes, std::size_t block_count,
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource(),
+      MemPoolOptions options = {})
+      : pool_(block_bytes, block_count, MemoryLocation::Host, options),
+        upstream_(upstream) {}
+
+  MemPoolResource(const MemPoolResource &) = delete;
+  MemPoolResource &operator=(const MemPoolResource &) = delete;
+
+  /**
+   * @brief Non-virtual allocation entry point (used by MemPoolAllocator).
+   */
+  void *allocate_bytes(std::size_t bytes, std::size_t alignment) {
+    if (bytes <= pool_.block_size() && alignment <= Alignment) {
+      if (std::byte *block = pool_.acquire_block()) {
+        return block;
+      }
+    }
+    upstream_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return upstream_->allocate(bytes, alignment);
+  }
+
+  /**
+   * @brief Non-virtual deallocation entry point (used by MemPoolAllocator).
+   */
+  void deallocate_bytes(void *p, std::size_t bytes,
+                        std::size_t alignment) noexcept {
+    auto *block = static_cast<std::byte *>(p);
+    if (pool_.owns(block)) {
+      pool_.release_block(block);
+    } else {
+      upstream_->deallocate(p, bytes, alignment);
+    }
+  }
+
+  /// @return the pool serving node-sized requests
+  const pool_type &pool() const noexcept { return pool_; }
+
+  /// @return the resource serving everything else
+  std::pmr::memory_resource *upstream_resource() const noexcept {
+    return upstream_;
+  }
+
+  /// @return number of requests forwarded upstream so far
+  std::size_t upstream_allocations() const noexcept {
+    return upstream_allocations_.load(std::memory_order_relaxed);
+  }
+
+protected:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return allocate_bytes(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    deallocate_bytes(p, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+private:
+  pool_type pool_;
+  std::pmr::memory_resource *upstream_;
+  std::atomic<std::size_t> upstream_allocations_{0};
+};
+
+/**
+ * @brief Standard-conforming allocator on top of a MemPoolResource.
+ *
+ * Unlike `std::pmr::polymorphic_allocator`, calls go straight to the resource
+ * without virtual dispatch. Copies and rebinds compare equal when they share
+ * the same resource.
+ */
+template <typename T, size_t Alignment = 64> class MemPoolAllocator {
+public:
+  using value_type = T;
+
+  template <typename U> struct rebind {
+    using other = MemPoolAllocator<U, Alignment>;
+  };
+
+  explicit MemPoolAllocator(MemPoolResource<Alignment> &resource) noexcept
+      : resource_(&resource) {}
+
+  template <typename U>
+  MemPoolAllocator(const MemPoolAllocator<U, Alignment> &other) noexcept
+      : resource_(other.resource()) {}
+
+  T *allocate(std::size_t n) {
+    if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T *>(
+        resource_->allocate_bytes(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    resource_->deallocate_bytes(p, n * sizeof(T), alignof(T));
+  }
+
+  MemPoolResource<Alignment> *resource() const noexcept { return resource_; }
+
+  template <typename U>
+  bool operator==(const MemPoolAllocator<U, Alignment> &other) const noexcept {
+    return resource_ == other.resource();
+  }
+
+private:
+  MemPoolResource<Alignment> *resource_;
+};
+} // namespace nstd::memory
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "MemPool.hpp"
+#include <memory>
+#include <stdexcept>
+
+namespace nstd::memory {
+/**
+ * @brief Default ObjectPool reset policy: calls `obj.reset()` if T has such a
+ * member, and does nothing otherwise.
+ */
+struct member_reset {
+  template <typename U> void operator()(U &obj) const noexcept {
+    if constexpr (requires { obj.reset(); }) {
+      obj.reset();
+    }
+  }
+};
+
+/**
+ * @brief A pool of reusable, expensive-to-construct objects.
+ *
+ * Objects are constructed in place the first time their slot is acquired and
+ * are never destroyed on release: the `Reset` policy is invoked instead to
+ * bring them back to a reusable state, so internal buffers and other
+ * resources survive across uses. All objects are destroyed with the pool.
+ *
+ * Handles are `std::unique_ptr<T, object_deleter>`; the deleter holds only a
+ * pool pointer and recycles through a direct call.
+ *
+ * @tparam T The pooled type (default constructible).
+ * @tparam Reset Callable invoked as `reset(obj)` on release. It must not
+ * throw.
+ * @tparam Alignment Alignment (and slot granularity) in bytes; the default
+ * keeps objects on separate cache lines.
+ */
+template <typename T, typename Reset = member_reset, size_t Alignment = 64>
+class ObjectPool {
+public:
+  /**
+   * @brief Deleter recycling an object into its pool.
+   */
+  struct object_deleter {
+    ObjectPool *pool = nullptr;
+
+    void operator()(T *p) const noexcept { pool->recycle(p); }
+  };
+
+  using handle_type = std::unique_ptr<T, object_deleter>;
+
+  /**
+   * @param capacity Maximum number of live objects.
+   * @param reset Reset policy instance.
+   * @param options Options forwarded to the backing MemPool (lazy
+   * construction is always enabled).
+   *
+   * @throws std::invalid_argument if capacity is 0.
+   */
+  explicit ObjectPool(std::size_t capacity, Reset reset = {},
+                      MemPoolOptions options = {})
+      : pool_(1, capacity, MemoryLocation::Host, lazy(options)),
+        reset_(std::move(reset)) {}
+
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  /**
+   * @brief Acquires an object, constructing it if its slot was never used.
+   *
+   * @throws std::runtime_error if all objects are in use.
+   * @throws Whatever T's default constructor throws.
+   *
+   * @warning The pool must outlive the returned handle.
+   */
+  handle_type acquire() {
+    T *obj = pool_.acquire_block();
+    if (!obj) {
+      throw std::runtime_error("ObjectPool: out of objects");
+    }
+    return handle_type(obj, object_deleter{this});
+  }
+
+  /// @return maximum number of live objects
+  std::size_t capacity() const noexcept { return pool_.capacity(); }
+
+  /// @return number of objects that can currently be acquired
+  std::size_t available() const noexcept { return pool_.available(); }
+
+  /// @return the backing pool (for stats, drain, etc.)
+  MemPool<T, Alignment> &pool() noexcept { return pool_; }
+
+private:
+  static MemPoolOptions lazy(MemPoolOptions options) noexcept {
+    options.lazy_construction = true;
+    options.poison_released = false; // Released objects are reused as-is
+    return options;
+  }
+
+  void recycle(T *obj) noexcept {
+    reset_(*obj);
+    pool_.release_block(obj);
+  }
+
+  MemPool<T, Alignment> pool_;
+  [[no_unique_address]] Reset reset_;
+};
+} // namespace nstd::memory
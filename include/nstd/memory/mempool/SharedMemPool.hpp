@@ -0,0 +1,420 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "../smart_buffers/unique_buffer.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace nstd::memory {
+/**
+ * @brief A fixed-size block pool living entirely in shared memory.
+ *
+ * The slab *and* its free list are stored in one `shm_open` (named) or
+ * `memfd_create` (anonymous) region, so several processes mapping the same
+ * region allocate from and release to the same pool. A block allocated in
+ * one process may be released by another one, without copying.
+ *
+ * Because every process maps the region at a different address, nothing in
+ * the region holds a pointer: blocks are identified by index, and the free
+ * list is a lock-free (tagged, ABA-safe) stack of indices updated with
+ * address-free 64-bit atomics.
+ *
+ * Hand a block to another process with `to_index()` and adopt it there with
+ * `from_index()`.
+ *
+ * @tparam T The element type; must be trivially copyable since the memory is
+ * shared between independent processes.
+ * @tparam Alignment The alignment of every block in bytes.
+ */
+template <typename T, size_t Alignment = 64> class SharedMemPool {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SharedMemPool requires trivially copyable T");
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "SharedMemPool requires lock-free 64-bit atomics");
+
+public:
+  using index_type = std::uint32_t;
+
+  /// Index value meaning "no block"
+  static constexpr index_type npos = static_cast<index_type>(-1);
+
+  /**
+   * @brief Pointer-sized deleter returning a block to the shared free list.
+   */
+  struct block_deleter {
+    SharedMemPool *pool = nullptr;
+
+    void operator()(T *p) const noexcept { pool->release_block(p); }
+  };
+
+  using buffer_type = unique_buffer<T, block_deleter>;
+
+  /**
+   * @brief Creates a new named region with `shm_open`.
+   *
+   * @param name POSIX shared memory name (e.g. "/my_pool").
+   * @param block_size The number of elements (T) in each block.
+   * @param block_count The total number of blocks.
+   *
+   * @throws std::invalid_argument on zero sizes or a count that does not fit
+   * an index.
+   * @throws std::system_error if the region already exists or cannot be
+   * created.
+   */
+  static SharedMemPool create(const std::string &name, std::size_t block_size,
+                              std::size_t block_count) {
+    validate(block_size, block_count);
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "SharedMemPool: shm_open");
+    }
+    try {
+      return SharedMemPool(fd, name, block_size, block_count);
+    } catch (...) {
+      ::shm_unlink(name.c_str());
+      throw;
+    }
+  }
+
+  /**
+   * @brief Creates an unnamed region with `memfd_create`.
+   *
+   * The region is shared with children created by `fork()`, or with other
+   * processes by passing `fd()` over a UNIX socket.
+   */
+  static SharedMemPool anonymous(std::size_t block_size,
+                                 std::size_t block_count) {
+    validate(block_size, block_count);
+    int fd = ::memfd_create("nstd_shared_mempool", MFD_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "SharedMemPool: memfd_create");
+    }
+    return SharedMemPool(fd, {}, block_size, block_count);
+  }
+
+  /**
+   * @brief Attaches to a region previously made by `create()`.
+   *
+   * @throws std::system_error if the region cannot be opened or mapped.
+   * @throws std::runtime_error if the region is not a compatible pool, or
+   * its creator has not finished initializing it yet (retry later).
+   */
+  static SharedMemPool open(const std::string &name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "SharedMemPool: shm_open");
+    }
+    return SharedMemPool(fd, name);
+  }
+
+  /**
+   * @brief Removes a named region. Existing mappings stay valid.
+   */
+  static void unlink(const std::string &name) noexcept {
+    ::shm_unlink(name.c_str());
+  }
+
+  SharedMemPool(const SharedMemPool &) = delete;
+  SharedMemPool &operator=(const SharedMemPool &) = delete;
+
+  /// Outstanding buffers refer to the handle they came from, so only move a
+  /// handle that has none (e.g. when returning it from a factory).
+  SharedMemPool(SharedMemPool &&other) noexcept
+      : fd_(std::exchange(other.fd_, -1)),
+        name_(std::move(other.name_)),
+        region_(std::exchange(other.region_, nullptr)),
+        region_size_(std::exchange(other.region_size_, 0)),
+        header_(std::exchange(other.header_, nullptr)),
+        next_(std::exchange(other.next_, nullptr)),
+        data_(std::exchange(other.data_, nullptr)) {}
+
+  /**
+   * @brief Unmaps the region. Does not unlink a named region.
+   *
+   * @warning Buffers allocated through this handle must be destroyed (or
+   * detached with `to_index()`) first.
+   */
+  ~SharedMemPool() {
+    if (region_) {
+      ::munmap(region_, region_size_);
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  /**
+   * @brief Allocates a block.
+   *
+   * @throws std::runtime_error if the pool is empty.
+   */
+  buffer_type allocate() {
+    T *ptr = acquire_block();
+    if (!ptr) {
+      throw std::runtime_error("SharedMemPool: out of buffers");
+    }
+    return buffer_type(ptr, header_->block_size, block_deleter{this});
+  }
+
+  /**
+   * @brief Low-level: pops a block off the shared free list.
+   *
+   * @return A pointer to `block_size()` elements, or nullptr if empty.
+   */
+  T *acquire_block() noexcept {
+    std::uint64_t head = header_->free_head.load(std::memory_order_acquire);
+    while (true) {
+      index_type index = index_of(head);
+      if (index == npos) {
+        return nullptr;
+      }
+      index_type next = next_[index].load(std::memory_order_relaxed);
+      if (header_->free_head.compare_exchange_weak(
+              head, pack(tag_of(head) + 1, next), std::memory_order_acq_rel,
+              std::memory_order_acquire)) {
+        header_->in_use.fetch_add(1, std::memory_order_relaxed);
+        return block_at(index);
+      }
+    }
+  }
+
+  /**
+   * @brief Low-level: pushes a block back onto the shared free list. May be
+   * called from any process mapping the region.
+   */
+  void release_block(T *p) noexcept {
+    index_type index = index_of_block(p);
+    std::uint64_t head = header_->free_head.load(std::memory_order_relaxed);
+    do {
+      next_[index].store(index_of(head), std::memory_order_relaxed);
+    } while (!header_->free_head.compare_exchange_weak(
+        head, pack(tag_of(head) + 1, index), std::memory_order_release,
+        std::memory_order_relaxed));
+    header_->in_use.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Detaches a buffer so its block can be handed to another process.
+   *
+   * @return The block index; the block stays allocated until some process
+   * adopts it with `from_index()` and releases it.
+   */
+  index_type to_index(buffer_type &&buf) noexcept {
+    T *ptr = buf.get();
+    auto released = buf.release();
+    (void)released;
+    return index_of_block(ptr);
+  }
+
+  /**
+   * @brief Adopts a block detached with `to_index()` (in any process).
+   *
+   * @throws std::out_of_range if the index is not a block of this pool.
+   */
+  buffer_type from_index(index_type index) {
+    if (index >= header_->block_count) {
+      throw std::out_of_range("SharedMemPool: invalid block index");
+    }
+    return buffer_type(block_at(index), header_->block_size,
+                       block_deleter{this});
+  }
+
+  /// @return pointer to block `index` in this process' mapping
+  T *block_at(index_type index) const noexcept {
+    return reinterpret_cast<T *>(data_ + index * header_->stride_bytes);
+  }
+
+  /// @return index of the block starting at `p`
+  index_type index_of_block(const T *p) const noexcept {
+    auto offset = reinterpret_cast<const unsigned char *>(p) - data_;
+    return static_cast<index_type>(static_cast<std::size_t>(offset) /
+                                   header_->stride_bytes);
+  }
+
+  /// @return number of elements in each block
+  std::size_t block_size() const noexcept { return header_->block_size; }
+
+  /// @return total number of blocks in the pool
+  std::size_t capacity() const noexcept { return header_->block_count; }
+
+  /// @return number of currently available blocks, across all processes
+  std::size_t available() const noexcept {
+    return header_->block_count -
+           header_->in_use.load(std::memory_order_relaxed);
+  }
+
+  /// @return the file descriptor of the region (e.g. to pass over a socket)
+  int fd() const noexcept { return fd_; }
+
+  /// @return the shm name, or an empty string for anonymous regions
+  const std::string &name() const noexcept { return name_; }
+
+private:
+  static constexpr std::uint64_t magic = 0x6e7374645f736d70; // "nstd_smp"
+
+  /// Lives at offset 0 of the region. Contains no pointers.
+  struct header {
+    /// Published last (release) by the creator, read first (acquire) by
+    /// `open()`: the rest of the header is valid once it matches.
+    std::uint64_t magic;
+    std::uint64_t element_size;
+    std::uint64_t alignment;
+    std::uint64_t block_size;
+    std::uint64_t block_count;
+    std::uint64_t stride_bytes;
+    std::uint64_t next_offset; ///< Offset of the index links
+    std::uint64_t data_offset; ///< Offset of block 0
+    /// (tag << 32) | head index, the tag defeats ABA on the lock-free stack
+    alignas(64) std::atomic<std::uint64_t> free_head;
+    alignas(64) std::atomic<std::uint64_t> in_use;
+  };
+
+  static void validate(std::size_t block_size, std::size_t block_count) {
+    if (block_size == 0 || block_count == 0) {
+      throw std::invalid_argument("block_size and block_count must be > 0");
+    }
+    if (block_count >= npos) {
+      throw std::invalid_argument("SharedMemPool: block_count too large");
+    }
+  }
+
+  static constexpr std::uint64_t pack(std::uint64_t tag,
+                                      index_type index) noexcept {
+    return (tag << 32) | index;
+  }
+  static constexpr index_type index_of(std::uint64_t head) noexcept {
+    return static_cast<index_type>(head & 0xffffffffu);
+  }
+  static constexpr std::uint64_t tag_of(std::uint64_t head) noexcept {
+    return head >> 32;
+  }
+  static constexpr std::size_t round_up(std::size_t value,
+                                        std::size_t to) noexcept {
+    return (value + to - 1) / to * to;
+  }
+
+  /// Create: size, map and initialize a fresh region.
+  SharedMemPool(int fd, std::string name, std::size_t block_size,
+                std::size_t block_count)
+      : fd_(fd), name_(std::move(name)) {
+    std::size_t stride = round_up(block_size * sizeof(T), Alignment);
+    std::size_t next_offset = round_up(sizeof(header), alignof(header));
+    std::size_t data_offset = round_up(
+        next_offset + block_count * sizeof(std::atomic<index_type>), Alignment);
+    std::size_t size = data_offset + stride * block_count;
+
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+      int error = errno;
+      cleanup_failed();
+      throw std::system_error(error, std::generic_category(),
+                              "SharedMemPool: ftruncate");
+    }
+    map(size);
+
+    // Default-initialized: `magic` keeps the zero of the fresh region rather
+    // than being written before the rest of the header.
+    header_ = new (region_) header;
+    header_->element_size = sizeof(T);
+    header_->alignment = Alignment;
+    header_->block_size = block_size;
+    header_->block_count = block_count;
+    header_->stride_bytes = stride;
+    header_->next_offset = next_offset;
+    header_->data_offset = data_offset;
+    bind_layout();
+
+    // Free list 0 -> 1 -> ... -> n-1 so blocks are handed out in slab order.
+    for (std::size_t i = 0; i < block_count; ++i) {
+      new (&next_[i]) std::atomic<index_type>(
+          i + 1 < block_count ? static_cast<index_type>(i + 1) : npos);
+    }
+    header_->in_use.store(0, std::memory_order_relaxed);
+    header_->free_head.store(pack(0, 0), std::memory_order_relaxed);
+    // Publish: a concurrent open() only trusts the header after this store.
+    std::atomic_ref<std::uint64_t>(header_->magic)
+        .store(magic, std::memory_order_release);
+  }
+
+  /// Open: map an existing region and validate its header.
+  SharedMemPool(int fd, std::string name) : fd_(fd), name_(std::move(name)) {
+    struct stat st {};
+    if (::fstat(fd_, &st) != 0 ||
+        static_cast<std::size_t>(st.st_size) < sizeof(header)) {
+      cleanup_failed();
+      throw std::runtime_error("SharedMemPool: region too small");
+    }
+    map(static_cast<std::size_t>(st.st_size));
+    header_ = static_cast<header *>(region_);
+    const char *error = nullptr;
+    if (std::atomic_ref<std::uint64_t>(header_->magic)
+            .load(std::memory_order_acquire) != magic) {
+      error = "SharedMemPool: region not initialized";
+    } else if (header_->element_size != sizeof(T) ||
+               header_->alignment != Alignment) {
+      error = "SharedMemPool: incompatible region";
+    } else if (header_->data_offset +
+                   header_->stride_bytes * header_->block_count >
+               region_size_) {
+      error = "SharedMemPool: region smaller than its layout";
+    }
+    if (error) {
+      ::munmap(region_, region_size_);
+      cleanup_failed();
+      throw std::runtime_error(error);
+    }
+    bind_layout();
+  }
+
+  void map(std::size_t size) {
+    void *region =
+        ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (region == MAP_FAILED) {
+      int error = errno;
+      cleanup_failed();
+      throw std::system_error(error, std::generic_category(),
+                              "SharedMemPool: mmap");
+    }
+    region_ = region;
+    region_size_ = size;
+  }
+
+  void bind_layout() noexcept {
+    auto *base = static_cast<unsigned char *>(region_);
+    next_ = reinterpret_cast<std::atomic<index_type> *>(base +
+                                                        header_->next_offset);
+    data_ = base + header_->data_offset;
+  }
+
+  /// Undo the parts of construction the destructor won't see.
+  void cleanup_failed() noexcept {
+    ::close(fd_);
+    fd_ = -1;
+    region_ = nullptr;
+  }
+
+  int fd_ = -1;
+  std::string name_;
+  void *region_ = nullptr;
+  std::size_t region_size_ = 0;
+  header *header_ = nullptr;
+  std::atomic<index_type> *next_ = nullptr;
+  unsigned char *data_ = nullptr; ///< Start of block 0 in this mapping
+};
+} // namespace nstd::memory
+
+#endif // defined(__linux__)
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "MemPool.hpp"
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace nstd::memory {
+/**
+ * @brief A family of MemPools serving variable-size requests from geometric
+ * size classes.
+ *
+ * The pool owns one MemPool slab per size class. Class sizes start at
+ * `min_block_size` and grow by `growth_factor` until `max_block_size` (which is
+ * always the last class). `allocate(n)` picks the smallest class that fits `n`
+ * elements, falling back to larger classes when that one is exhausted.
+ *
+ * The returned buffer reports the *requested* size; the difference to the
+ * class size is tracked as internal fragmentation (see `fragmentation()`).
+ *
+ * @tparam T The type of elements in the pool.
+ * @tparam Alignment The alignment requirement in bytes (default 64 for SIMD).
+ */
+template <typename T, size_t Alignment = 64> class SizeClassPool {
+public:
+  using pool_type = MemPool<T, Alignment>;
+
+  /**
+   * @brief Deleter returning a block to its size class.
+   *
+   * Carries the requested count so fragmentation accounting stays exact.
+   */
+  struct block_deleter {
+    SizeClassPool *pool = nullptr;
+    std::size_t size_class = 0;
+    std::size_t requested = 0;
+
+    void operator()(T *p) const noexcept {
+      pool->release_block(size_class, requested, p);
+    }
+  };
+
+  using buffer_type = unique_buffer<T, block_deleter>;
+
+  /**
+   * @brief Live internal fragmentation, in elements.
+   */
+  struct fragmentation_stats {
+    std::size_t requested_elements = 0; ///< Sum of sizes handed out
+    std::size_t reserved_elements = 0;  ///< Sum of class sizes backing them
+
+    /// @return Elements reserved but not requested
+    std::size_t wasted_elements() const noexcept {
+      // The two counters are sampled independently and may briefly disagree.
+      return reserved_elements > requested_elements
+                 ? reserved_elements - requested_elements
+                 : 0;
+    }
+
+    /// @return Wasted fraction of the reserved elements in [0, 1)
+    double ratio() const noexcept {
+      return reserved_elements == 0
+                 ? 0.0
+                 : static_cast<double>(wasted_elements()) /
+                       static_cast<double>(reserved_elements);
+    }
+  };
+
+  /**
+   * @brief Constructs one MemPool per geometric size class.
+   *
+   * @param min_block_size Elements in the smallest class.
+   * @param max_block_size Elements in the largest class.
+   * @param blocks_per_class Number of blocks pre-allocated in every class.
+   * @param growth_factor Ratio between consecutive class sizes (> 1).
+   * @param loc The metadata location tag (e.g., Host).
+   *
+   * @throws std::invalid_argument on zero sizes/counts, max < min or
+   * growth_factor <= 1.
+   * @throws std::bad_alloc if memory allocation fails.
+   */
+  SizeClassPool(std::size_t min_block_size, std::size_t max_block_size,
+                std::size_t blocks_per_class, double growth_factor = 2.0,
+                MemoryLocation loc = MemoryLocation::Host)
+      : location_(loc) {
+    if (min_block_size == 0 || blocks_per_class == 0) {
+      throw std::invalid_argument(
+          "min_block_size and blocks_per_class must be > 0");
+    }
+    if (max_block_size < min_block_size) {
+      throw std::invalid_argument("max_block_size must be >= min_block_size");
+    }
+    if (!(growth_factor > 1.0)) {
+      throw std::invalid_argument("growth_factor must be > 1");
+    }
+
+    std::size_t size = min_block_size;
+    while (size < max_block_size) {
+      class_sizes_.push_back(size);
+      auto next = static_cast<std::size_t>(
+          std::ceil(static_cast<double>(size) * growth_factor));
+      size = next > size ? next : size + 1;
+    }
+    class_sizes_.push_back(max_block_size);
+
+    pools_.reserve(class_sizes_.size());
+    for (std::size_t class_size : class_sizes_) {
+      pools_.push_back(
+          std::make_unique<pool_type>(class_size, blocks_per_class, loc));
+    }
+  }
+
+  SizeClassPool(const SizeClassPool &) = delete;
+  SizeClassPool &operator=(const SizeClassPool &) = delete;
+
+  /**
+   * @brief Allocates a buffer of exactly `count` elements.
+   *
+   * @return A `unique_buffer` whose `size()` is `count`, backed by the
+   * smallest size class with a free block.
+   *
+   * @throws std::invalid_argument if count is 0 or exceeds the largest class.
+   * @throws std::runtime_error if every fitting class is exhausted.
+   *
+   * @warning The pool must outlive the returned buffer.
+   */
+  buffer_type allocate(std::size_t count) {
+    if (count == 0 || count > class_sizes_.back()) {
+      throw std::invalid_argument("SizeClassPool: unsupported request size");
+    }
+    for (std::size_t c = class_for(count); c < pools_.size(); ++c) {
+      if (T *ptr = pools_[c]->acquire_block()) {
+        requested_.fetch_add(count, std::memory_order_relaxed);
+        reserved_.fetch_add(class_sizes_[c], std::memory_order_relaxed);
+        return buffer_type(ptr, count, block_deleter{this, c, count},
+                           location_);
+      }
+    }
+    throw std::runtime_error("SizeClassPool: out of buffers");
+  }
+
+  /**
+   * @return Index of the smallest class holding at least `count` elements, or
+   * `class_count()` if none does.
+   */
+  std::size_t class_for(std::size_t count) const noexcept {
+    std::size_t lo = 0;
+    std::size_t hi = class_sizes_.size();
+    while (lo < hi) {
+      std::size_t mid = lo + (hi - lo) / 2;
+      if (class_sizes_[mid] < count) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /// @return number of size classes
+  std::size_t class_count() const noexcept { return class_sizes_.size(); }
+
+  /// @return element counts of every class, ascending
+  const std::vector<std::size_t> &class_sizes() const noexcept {
+    return class_sizes_;
+  }
+
+  /// @return the MemPool backing class `size_class`
+  const pool_type &size_class_pool(std::size_t size_class) const {
+    return *pools_.at(size_class);
+  }
+
+  /// @return current internal fragmentation of outstanding buffers
+  fragmentation_stats fragmentation() const noexcept {
+    fragmentation_stats stats;
+    stats.requested_elements = requested_.load(std::memory_order_relaxed);
+    stats.reserved_elements = reserved_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  void release_block(std::size_t size_class, std::size_t requested,
+                     T *p) noexcept {
+    pools_[size_class]->release_block(p);
+    requested_.fetch_sub(requested, std::memory_order_relaxed);
+    reserved_.fetch_sub(class_sizes_[size_class], std::memory_order_relaxed);
+  }
+
+  std::vector<std::size_t> class_sizes_;
+  std::vector<std::unique_ptr<pool_type>> pools_;
+  MemoryLocation location_ = MemoryLocation::Host;
+  std::atomic<std::size_t> requested_{0};
+  std::atomic<std::size_t> reserved_{0};
+};
+} // namespace nstd::memory
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * Define NSTD_MEMPOOL_HARDENED=1 (e.g. through the CMake option of the same
+ * name) to compile the memory pools in hardened debug mode:
+ * - released pointers are validated (in range, on a block boundary),
+ * - double releases are detected,
+ * - canaries in the alignment padding of every block catch overruns,
+ * - released blocks are poisoned and checked for writes on reuse,
+ * - under AddressSanitizer, released blocks and padding are poisoned with
+ *   `ASAN_POISON_MEMORY_REGION`, so any access is reported immediately.
+ *
+ * Violations abort with a diagnostic on stderr. The mode must be the same in
+ * every translation unit that instantiates a given pool type.
+ */
+#ifndef NSTD_MEMPOOL_HARDENED
+#define NSTD_MEMPOOL_HARDENED 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define NSTD_MEMPOOL_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define NSTD_MEMPOOL_ASAN 1
+#endif
+#endif
+#ifndef NSTD_MEMPOOL_ASAN
+#define NSTD_MEMPOOL_ASAN 0
+#endif
+
+#if NSTD_MEMPOOL_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace nstd::memory::hardening {
+/// True when the pools are compiled in hardened debug mode
+inline constexpr bool enabled = NSTD_MEMPOOL_HARDENED != 0;
+
+/// True when AddressSanitizer manual poisoning is available
+inline constexpr bool asan = NSTD_MEMPOOL_ASAN != 0;
+
+/// Byte written over released blocks
+inline constexpr unsigned char poison_byte = 0xDD;
+
+/// Byte written into the padding between a block's end and the next block
+inline constexpr unsigned char canary_byte = 0xCA;
+
+/**
+ * @brief Mark `[addr, addr + len)` as inaccessible for AddressSanitizer.
+ * No-op without ASan.
+ */
+inline void poison_region(const void *addr, std::size_t len) noexcept {
+#if NSTD_MEMPOOL_ASAN
+  ASAN_POISON_MEMORY_REGION(addr, len);
+#else
+  (void)addr;
+  (void)len;
+#endif
+}
+
+/**
+ * @brief Mark `[addr, addr + len)` as accessible again. No-op without ASan.
+ */
+inline void unpoison_region(const void *addr, std::size_t len) noexcept {
+#if NSTD_MEMPOOL_ASAN
+  ASAN_UNPOISON_MEMORY_REGION(addr, len);
+#else
+  (void)addr;
+  (void)len;
+#endif
+}
+
+/// Fill `[addr, addr + len)` with `pattern`.
+inline void fill(void *addr, std::size_t len, unsigned char pattern) noexcept {
+  std::memset(addr, pattern, len);
+}
+
+/// @return true if every byte of `[addr, addr + len)` equals `pattern`
+inline bool intact(const void *addr, std::size_t len,
+                   unsigned char pattern) noexcept {
+  const auto *bytes = static_cast<const unsigned char *>(addr);
+  for (std::size_t i = 0; i < len; ++i) {
+    if (bytes[i] != pattern) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Report a non-fatal misuse of pool `pool` on stderr.
+ * @param details Further lines (may be empty).
+ */
+inline void report(const void *pool, const char *what,
+                   const char *details) noexcept {
+  std::fprintf(stderr, "MemPool %p: %s\n%s", pool, what, details);
+}
+
+/**
+ * @brief Report a corruption of pool `pool` around block `block` and abort.
+ */
+[[noreturn]] inline void fail(const void *pool, const char *what,
+                              const void *block) noexcept {
+  std::fprintf(stderr, "MemPool %p: %s (block %p)\n", pool, what, block);
+  std::abort();
+}
+} // namespace nstd::memory::hardening
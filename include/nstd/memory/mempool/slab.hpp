@@ -0,0 +1,220 @@
+#pragma once
+
+#include "../numa.hpp"
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace nstd::memory {
+/**
+ * Where the backing memory of a pool slab comes from.
+ */
+enum class SlabBacking {
+  Heap,                 /// std::aligned_alloc
+  Mmap,                 /// anonymous mmap with regular pages
+  TransparentHugePages, /// anonymous mmap + madvise(MADV_HUGEPAGE)
+  HugePages             /// anonymous mmap with MAP_HUGETLB (explicit hugetlbfs)
+};
+
+/**
+ * @brief Move-only owner of one large, aligned, raw memory region.
+ *
+ * A slab is requested with a preferred backing and degrades step by step when
+ * that backing is unavailable (HugePages -> TransparentHugePages -> Mmap ->
+ * Heap). `backing()` reports what was actually obtained, so callers can log or
+ * assert on it.
+ */
+class slab {
+public:
+  /// Size of the huge pages requested for MAP_HUGETLB / THP alignment
+  static constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+  slab() noexcept = default;
+
+  /**
+   * @param bytes Minimum usable size in bytes.
+   * @param alignment Required alignment of `data()` (power of two).
+   * @param backing The preferred backing.
+   * @param populate Fault all pages in up front (MAP_POPULATE or touching).
+   * @param lock mlock() the region; failure is reported by `locked()`.
+   *
+   * @throws std::bad_alloc if no backing could provide the memory.
+   */
+  slab(std::size_t bytes, std::size_t alignment,
+       SlabBacking backing = SlabBacking::Heap, bool populate = false,
+       bool lock = false) {
+#if defined(__linux__)
+    if (backing == SlabBacking::HugePages) {
+      if (map(bytes, alignment, huge_page_size, MAP_HUGETLB, populate)) {
+        backing_ = SlabBacking::HugePages;
+      } else {
+        backing = SlabBacking::TransparentHugePages;
+      }
+    }
+    if (!data_ && backing == SlabBacking::TransparentHugePages) {
+      if (map(bytes, alignment, huge_page_size, 0, false)) {
+        backing_ = ::madvise(data_, size_, MADV_HUGEPAGE) == 0
+                       ? SlabBacking::TransparentHugePages
+                       : SlabBacking::Mmap;
+        if (populate) {
+          prefault();
+        }
+      } else {
+        backing = SlabBacking::Mmap;
+      }
+    }
+    if (!data_ && backing == SlabBacking::Mmap) {
+      if (map(bytes, alignment, numa::page_size(), 0, populate)) {
+        backing_ = SlabBacking::Mmap;
+      }
+    }
+#endif
+    if (!data_) {
+      std::size_t size = (bytes + alignment - 1) / alignment * alignment;
+      data_ = std::aligned_alloc(alignment, size);
+      if (!data_) {
+        throw std::bad_alloc();
+      }
+      size_ = size;
+      backing_ = SlabBacking::Heap;
+      if (populate) {
+        prefault();
+      }
+    }
+#if defined(__linux__)
+    if (lock) {
+      locked_ = ::mlock(data_, size_) == 0;
+    }
+#else
+    (void)lock;
+#endif
+  }
+
+  slab(const slab &) = delete;
+  slab &operator=(const slab &) = delete;
+
+  slab(slab &&other) noexcept { steal_from(std::move(other)); }
+
+  slab &operator=(slab &&other) noexcept {
+    if (this != &other) {
+      reset();
+      steal_from(std::move(other));
+    }
+    return *this;
+  }
+
+  ~slab() { reset(); }
+
+  /// @return start of the usable region
+  void *data() const noexcept { return data_; }
+
+  /// @return usable size in bytes (may exceed the requested size)
+  std::size_t size() const noexcept { return size_; }
+
+  /// @return the backing that was actually obtained
+  SlabBacking backing() const noexcept { return backing_; }
+
+  /// @return true if the region is mlock()ed
+  bool locked() const noexcept { return locked_; }
+
+  /**
+   * @brief Touch one byte per page so every page is faulted in now rather than
+   * on first use.
+   */
+  void prefault() noexcept { prefault(0, size_); }
+
+  /**
+   * @brief Fault in the pages overlapping `[offset, offset + len)`.
+   */
+  void prefault(std::size_t offset, std::size_t len) noexcept {
+    auto *bytes = static_cast<volatile unsigned char *>(data_);
+    std::size_t page = numa::page_size();
+    std::size_t end = offset + len < size_ ? offset + len : size_;
+    for (std::size_t i = offset / page * page; i < end; i += page) {
+      bytes[i] = 0;
+    }
+  }
+
+  /**
+   * Free the region (if any). The slab becomes empty.
+   */
+  void reset() noexcept {
+    if (!data_) {
+      return;
+    }
+#if defined(__linux__)
+    if (backing_ != SlabBacking::Heap) {
+      ::munmap(data_, size_);
+    } else {
+      std::free(data_);
+    }
+#else
+    std::free(data_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    backing_ = SlabBacking::Heap;
+    locked_ = false;
+  }
+
+private:
+#if defined(__linux__)
+  /**
+   * Map at least `bytes`, rounded to `granularity`, such that the usable region
+   * starts at a multiple of `max(alignment, granularity)`. Over-maps and trims
+   * the unaligned head and tail when needed.
+   */
+  bool map(std::size_t bytes, std::size_t alignment, std::size_t granularity,
+           int extra_flags, bool populate) noexcept {
+    std::size_t align = alignment > granularity ? alignment : granularity;
+    std::size_t size = (bytes + granularity - 1) / granularity * granularity;
+    bool over_aligned = align > numa::page_size();
+    std::size_t slack =
+        over_aligned && !(extra_flags & MAP_HUGETLB) ? align : 0;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | extra_flags;
+    if (populate) {
+      flags |= MAP_POPULATE;
+    }
+    void *base = ::mmap(nullptr, size + slack, PROT_READ | PROT_WRITE, flags,
+                        -1, 0);
+    if (base == MAP_FAILED) {
+      return false;
+    }
+    auto addr = reinterpret_cast<std::uintptr_t>(base);
+    auto aligned = (addr + align - 1) / align * align;
+    if (aligned + size > addr + size + slack) {
+      ::munmap(base, size + slack);
+      return false;
+    }
+    // Give back the unaligned head and the unused tail.
+    if (aligned > addr) {
+      ::munmap(base, aligned - addr);
+    }
+    std::size_t tail = addr + size + slack - (aligned + size);
+    if (tail > 0) {
+      ::munmap(reinterpret_cast<void *>(aligned + size), tail);
+    }
+    data_ = reinterpret_cast<void *>(aligned);
+    size_ = size;
+    return true;
+  }
+#endif
+
+  void steal_from(slab &&other) noexcept {
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    backing_ = std::exchange(other.backing_, SlabBacking::Heap);
+    locked_ = std::exchange(other.locked_, false);
+  }
+
+  void *data_ = nullptr;
+  std::size_t size_ = 0;
+  SlabBacking backing_ = SlabBacking::Heap;
+  bool locked_ = false;
+};
+} // namespace nstd::memory
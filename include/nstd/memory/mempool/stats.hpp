@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace nstd::memory {
+/**
+ * @brief Point-in-time copy of a pool's instrumentation counters.
+ *
+ * Counters are sampled individually with relaxed loads, so a snapshot taken
+ * while other threads allocate is not a single consistent cut; every value is
+ * however monotonic (except `in_use`) and never torn.
+ */
+struct MemPoolStats {
+  /// Bucket `i` counts acquisitions that took less than 2^i ns (and at least
+  /// 2^(i-1) ns); the last bucket also collects everything slower.
+  static constexpr std::size_t latency_buckets = 40;
+
+  std::uint64_t allocations = 0;        ///< Successful acquisitions
+  std::uint64_t releases = 0;           ///< Blocks returned
+  std::uint64_t failed_allocations = 0; ///< Acquisitions on an empty pool
+  std::uint64_t in_use = 0;             ///< Blocks currently handed out
+  std::uint64_t peak_in_use = 0;        ///< High-water mark of `in_use`
+  std::uint64_t local_hits = 0;  ///< Served from the caller's NUMA node
+  std::uint64_t remote_hits = 0; ///< Served by stealing from another node
+  std::uint64_t lock_wait_ns = 0; ///< Total time spent waiting for the lock
+  std::array<std::uint64_t, latency_buckets> acquire_latency{};
+
+  /**
+   * @param quantile In [0, 1], e.g. 0.99 for p99.
+   * @return Upper bound (ns) of the latency bucket containing the quantile,
+   * or 0 if nothing was recorded.
+   */
+  std::uint64_t latency_percentile_ns(double quantile) const noexcept {
+    std::uint64_t total = 0;
+    for (auto count : acquire_latency) {
+      total += count;
+    }
+    if (total == 0) {
+      return 0;
+    }
+    auto rank =
+        static_cast<std::uint64_t>(quantile * static_cast<double>(total));
+    if (rank >= total) {
+      rank = total - 1;
+    }
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < latency_buckets; ++i) {
+      seen += acquire_latency[i];
+      if (seen > rank) {
+        return std::uint64_t{1} << i;
+      }
+    }
+    return std::uint64_t{1} << (latency_buckets - 1);
+  }
+};
+
+/**
+ * @brief Lock-free counters behind MemPoolStats.
+ *
+ * Every update is a single relaxed atomic RMW so recording never takes a
+ * lock, and `snapshot()` can be called from a metrics thread at any time.
+ * The object is cache-line aligned so the counters don't share a line with
+ * the pool's own state.
+ */
+class alignas(64) pool_counters {
+public:
+  using clock = std::chrono::steady_clock;
+
+  void record_acquire(clock::time_point start, clock::time_point locked,
+                      clock::time_point done, bool local,
+                      std::uint64_t in_use) noexcept {
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    (local ? local_hits_ : remote_hits_)
+        .fetch_add(1, std::memory_order_relaxed);
+    lock_wait_ns_.fetch_add(nanoseconds(start, locked),
+                            std::memory_order_relaxed);
+    acquire_latency_[bucket_of(nanoseconds(start, done))].fetch_add(
+        1, std::memory_order_relaxed);
+
+    std::uint64_t peak = peak_in_use_.load(std::memory_order_relaxed);
+    while (in_use > peak && !peak_in_use_.compare_exchange_weak(
+                                peak, in_use, std::memory_order_relaxed)) {
+    }
+  }
+
+  void record_failure(clock::time_point start,
+                      clock::time_point locked) noexcept {
+    failed_allocations_.fetch_add(1, std::memory_order_relaxed);
+    lock_wait_ns_.fetch_add(nanoseconds(start, locked),
+                            std::memory_order_relaxed);
+  }
+
+  void record_release() noexcept {
+    releases_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// @param in_use Current number of outstanding blocks, owned by the pool
+  MemPoolStats snapshot(std::uint64_t in_use) const noexcept {
+    MemPoolStats stats;
+    stats.allocations = allocations_.load(std::memory_order_relaxed);
+    stats.releases = releases_.load(std::memory_order_relaxed);
+    stats.failed_allocations =
+        failed_allocations_.load(std::memory_order_relaxed);
+    stats.in_use = in_use;
+    stats.peak_in_use = peak_in_use_.load(std::memory_order_relaxed);
+    stats.local_hits = local_hits_.load(std::memory_order_relaxed);
+    stats.remote_hits = remote_hits_.load(std::memory_order_relaxed);
+    stats.lock_wait_ns = lock_wait_ns_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < MemPoolStats::latency_buckets; ++i) {
+      stats.acquire_latency[i] =
+          acquire_latency_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+
+private:
+  static std::uint64_t nanoseconds(clock::time_point from,
+                                   clock::time_point to) noexcept {
+    auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+  }
+
+  static std::size_t bucket_of(std::uint64_t ns) noexcept {
+    auto bucket = static_cast<std::size_t>(std::bit_width(ns));
+    return bucket < MemPoolStats::latency_buckets
+               ? bucket
+               : MemPoolStats::latency_buckets - 1;
+  }
+
+  std::atomic<std::uint64_t> allocations_{0};
+  std::atomic<std::uint64_t> releases_{0};
+  std::atomic<std::uint64_t> failed_allocations_{0};
+  std::atomic<std::uint64_t> peak_in_use_{0};
+  std::atomic<std::uint64_t> local_hits_{0};
+  std::atomic<std::uint64_t> remote_hits_{0};
+  std::atomic<std::uint64_t> lock_wait_ns_{0};
+  std::array<std::atomic<std::uint64_t>, MemPoolStats::latency_buckets>
+      acquire_latency_{};
+};
+} // namespace nstd::memory
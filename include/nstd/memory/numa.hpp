@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <fstream>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Minimal NUMA helpers used by the memory pools.
+ *
+ * On Linux these talk to the kernel directly (sysfs, `getcpu`, `mbind`) so no
+ * libnuma dependency is required. Everywhere else, and whenever a query
+ * fails, they degrade to a single node (node 0) and binding becomes a no-op.
+ */
+namespace nstd::memory::numa {
+/**
+ * @return The system page size in bytes (4096 if it cannot be queried).
+ */
+inline std::size_t page_size() noexcept {
+#if defined(__linux__)
+  static const std::size_t size = [] {
+    long value = ::sysconf(_SC_PAGESIZE);
+    return value > 0 ? static_cast<std::size_t>(value) : std::size_t{4096};
+  }();
+  return size;
+#else
+  return 4096;
+#endif
+}
+
+namespace detail {
+/**
+ * @brief Parses a sysfs node list such as "0", "0-1" or "0,2-3".
+ * @return The ids in ascending order (empty if none could be parsed).
+ */
+inline std::vector<std::size_t> parse_node_list(std::string_view list) {
+  std::vector<std::size_t> ids;
+  std::size_t value = 0;
+  std::size_t range_start = 0;
+  bool in_number = false;
+  bool in_range = false;
+  auto flush = [&] {
+    if (in_number) {
+      for (std::size_t id = in_range ? range_start : value; id <= value; ++id) {
+        ids.push_back(id);
+      }
+    }
+    value = 0;
+    in_number = false;
+    in_range = false;
+  };
+  for (char c : list) {
+    if (c >= '0' && c <= '9') {
+      value = value * 10 + static_cast<std::size_t>(c - '0');
+      in_number = true;
+    } else if (c == '-' && in_number && !in_range) {
+      range_start = value;
+      value = 0;
+      in_number = false;
+      in_range = true;
+    } else {
+      flush();
+    }
+  }
+  flush();
+  return ids;
+}
+} // namespace detail
+
+/**
+ * @return The ids of the online NUMA nodes, ascending. Ids may be sparse
+ * (e.g. {0, 2}). Never empty: {0} if the topology cannot be read.
+ */
+inline const std::vector<std::size_t> &online_nodes() {
+  static const std::vector<std::size_t> nodes = [] {
+    std::vector<std::size_t> ids;
+#if defined(__linux__)
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (online && std::getline(online, list)) {
+      ids = detail::parse_node_list(list);
+    }
+#endif
+    if (ids.empty()) {
+      ids.push_back(0);
+    }
+    return ids;
+  }();
+  return nodes;
+}
+
+/**
+ * @return The number of online NUMA nodes. Always at least 1.
+ */
+inline std::size_t node_count() noexcept {
+  try {
+    return online_nodes().size();
+  } catch (...) {
+    return 1;
+  }
+}
+
+/**
+ * @return The NUMA node of the CPU the calling thread currently runs on, or 0
+ * if unknown.
+ */
+inline std::size_t current_node() noexcept {
+#if defined(__linux__) && defined(__GLIBC__) &&                               \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+  // glibc's getcpu() goes through the vDSO where available: no syscall.
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (::getcpu(&cpu, &node) == 0) {
+    return node;
+  }
+#elif defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+/**
+ * @return `current_node()` as of at most `refresh_interval` calls ago on this
+ * thread. For hot paths where a slightly stale answer (after the scheduler
+ * migrated the thread to another node) only costs locality.
+ */
+inline std::size_t cached_current_node() noexcept {
+  constexpr unsigned refresh_interval = 64;
+  thread_local std::size_t node = 0;
+  thread_local unsigned calls_left = 0;
+  if (calls_left == 0) {
+    node = current_node();
+    calls_left = refresh_interval;
+  }
+  --calls_left;
+  return node;
+}
+
+/**
+ * @brief Sets a preferred-node memory policy on the pages fully contained in
+ * `[addr, addr + len)`.
+ *
+ * Must be called before the pages are first touched to have an effect. The
+ * "preferred" policy falls back to other nodes when the target node is full,
+ * so allocation never fails because of it.
+ *
+ * @return true if the kernel accepted the policy.
+ */
+inline bool bind_to_node(void *addr, std::size_t len,
+                         std::size_t node) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int mpol_preferred = 1; /// MPOL_PREFERRED from <numaif.h>
+  constexpr std::size_t mask_bits = 1024;
+  constexpr std::size_t word_bits = sizeof(unsigned long) * 8;
+  if (node >= mask_bits) {
+    return false;
+  }
+
+  auto page = page_size();
+  auto begin = reinterpret_cast<std::uintptr_t>(addr);
+  auto end = begin + len;
+  begin = (begin + page - 1) / page * page;
+  end = end / page * page;
+  if (end <= begin) {
+    return false;
+  }
+
+  unsigned long mask[mask_bits / word_bits] = {};
+  mask[node / word_bits] = 1UL << (node % word_bits);
+  return ::syscall(SYS_mbind, reinterpret_cast<void *>(begin), end - begin,
+                   mpol_preferred, mask, mask_bits, 0) == 0;
+#else
+  (void)addr;
+  (void)len;
+  (void)node;
+  return false;
+#endif
+}
+} // namespace nstd::memory::numa
@@ -0,0 +1,451 @@
+#pragma once
+
+#include "../concepts.h"
+#include "buffer_base.hpp"
+#include "shared_buffer.hpp"
+#include "unique_buffer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#endif
+
+namespace nstd::memory {
+namespace detail {
+#if defined(__unix__) || defined(__APPLE__)
+/// Segment descriptor: POSIX `iovec`, so `iovecs()` needs no conversion
+using io_segment = ::iovec;
+#else
+/// Segment descriptor with the members of POSIX `iovec`
+struct io_segment {
+  void *iov_base;
+  std::size_t iov_len;
+};
+#endif
+
+/**
+ * Minimal vector keeping its first `N` elements inline. Only what
+ * buffer_chain needs: elements must be nothrow move constructible, so every
+ * operation except growing (and constructing the new element) is noexcept.
+ */
+template <typename T, std::size_t N> class small_vector {
+  static_assert(std::is_nothrow_move_constructible_v<T> &&
+                    std::is_nothrow_move_assignable_v<T>,
+                "small_vector requires nothrow movable elements");
+
+public:
+  small_vector() noexcept = default;
+
+  small_vector(const small_vector &other) : small_vector() {
+    reserve(other.size_);
+    std::uninitialized_copy_n(other.data(), other.size_, data());
+    size_ = other.size_;
+  }
+
+  small_vector(small_vector &&other) noexcept { steal_from(other); }
+
+  small_vector &operator=(const small_vector &other) {
+    if (this != &other) {
+      small_vector copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  small_vector &operator=(small_vector &&other) noexcept {
+    if (this != &other) {
+      clear();
+      deallocate();
+      steal_from(other);
+    }
+    return *this;
+  }
+
+  ~small_vector() {
+    clear();
+    deallocate();
+  }
+
+  T *data() noexcept { return heap_ ? heap_ : inline_data(); }
+  const T *data() const noexcept { return heap_ ? heap_ : inline_data(); }
+  std::size_t size() const noexcept { return size_; }
+  T &operator[](std::size_t i) noexcept { return data()[i]; }
+  const T &operator[](std::size_t i) const noexcept { return data()[i]; }
+
+  void reserve(std::size_t capacity) {
+    if (capacity <= capacity_) {
+      return;
+    }
+    capacity = std::max(capacity, capacity_ * 2);
+    T *storage = std::allocator<T>().allocate(capacity);
+    std::uninitialized_move_n(data(), size_, storage);
+    std::destroy_n(data(), size_);
+    deallocate();
+    heap_ = storage;
+    capacity_ = capacity;
+  }
+
+  /// Construct an element at index `pos`, shifting the tail up by one.
+  template <typename... Args>
+  void emplace(std::size_t pos, Args &&...args) {
+    T value(std::forward<Args>(args)...);
+    reserve(size_ + 1);
+    T *first = data();
+    if (pos == size_) {
+      ::new (first + size_) T(std::move(value));
+    } else {
+      ::new (first + size_) T(std::move(first[size_ - 1]));
+      std::move_backward(first + pos, first + size_ - 1, first + size_);
+      first[pos] = std::move(value);
+    }
+    ++size_;
+  }
+
+  /// Remove the elements in `[first, last)`.
+  void erase(std::size_t first, std::size_t last) noexcept {
+    T *elements = data();
+    std::move(elements + last, elements + size_, elements + first);
+    std::destroy(elements + size_ - (last - first), elements + size_);
+    size_ -= last - first;
+  }
+
+  void clear() noexcept {
+    std::destroy_n(data(), size_);
+    size_ = 0;
+  }
+
+private:
+  T *inline_data() noexcept {
+    return std::launder(reinterpret_cast<T *>(inline_));
+  }
+  const T *inline_data() const noexcept {
+    return std::launder(reinterpret_cast<const T *>(inline_));
+  }
+
+  void deallocate() noexcept {
+    if (heap_) {
+      std::allocator<T>().deallocate(heap_, capacity_);
+      heap_ = nullptr;
+      capacity_ = N;
+    }
+  }
+
+  /// Requires this vector to be empty and inline.
+  void steal_from(small_vector &other) noexcept {
+    if (other.heap_) {
+      heap_ = std::exchange(other.heap_, nullptr);
+      capacity_ = std::exchange(other.capacity_, N);
+    } else {
+      std::uninitialized_move_n(other.inline_data(), other.size_,
+                                inline_data());
+      std::destroy_n(other.inline_data(), other.size_);
+    }
+    size_ = std::exchange(other.size_, 0);
+  }
+
+  alignas(T) std::byte inline_[N * sizeof(T)];
+  T *heap_ = nullptr; ///< Null while the elements are stored inline
+  std::size_t size_ = 0;
+  std::size_t capacity_ = N;
+};
+} // namespace detail
+
+/**
+ * @brief Scatter-gather sequence of buffer segments forming one logical
+ * message, e.g. a header in one buffer followed by a payload slice of another.
+ *
+ * Segments are either owning (`shared_buffer`, kept alive by the chain) or
+ * borrowed (`buffer_base` views; the caller keeps the memory alive). Nothing
+ * is copied: on POSIX systems `iovecs()` exposes the segments directly for
+ * `writev()` / `sendmsg()`, and the iterators walk the elements across
+ * segment boundaries.
+ *
+ * The first `N` segments are stored inline. Empty segments are never stored.
+ * Any modification invalidates iterators and the span returned by
+ * `iovecs()`.
+ *
+ * @tparam T Element type; segments must be in host memory.
+ * @tparam N Number of segments stored without a heap allocation.
+ */
+template <concepts::TriviallyCopyable T, std::size_t N = 4>
+class buffer_chain {
+  template <bool Const> class basic_iterator;
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  buffer_chain() noexcept = default;
+
+  /// Copies share every owning segment (refcount increments, no data copy)
+  buffer_chain(const buffer_chain &) = default;
+  buffer_chain &operator=(const buffer_chain &) = default;
+
+  buffer_chain(buffer_chain &&other) noexcept
+      : segments_(std::move(other.segments_)),
+        iovecs_(std::move(other.iovecs_)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  buffer_chain &operator=(buffer_chain &&other) noexcept {
+    if (this != &other) {
+      segments_ = std::move(other.segments_);
+      iovecs_ = std::move(other.iovecs_);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  /// Owning segment at the end of the chain (ignored if empty)
+  void append(shared_buffer<T> buffer) {
+    insert(segments_.size(), std::move(buffer));
+  }
+
+  /// Borrowed segment at the end of the chain (ignored if empty)
+  void append(buffer_base<T> view) {
+    insert(segments_.size(), shared_buffer<T>(), view.data(), view.size());
+  }
+
+  /// Takes ownership of a unique_buffer (shared with nothing else)
+  template <typename Deleter> void append(unique_buffer<T, Deleter> &&buffer) {
+    append(shared_buffer<T>(std::move(buffer)));
+  }
+
+  /// Moves all segments of `other` to the end of this chain. Appending a
+  /// chain to itself repeats its segments (owning ones are shared).
+  void append(buffer_chain &&other) {
+    if (&other == this) {
+      // The loop below would read the storage it grows, then clear it.
+      append(buffer_chain(*this));
+      return;
+    }
+    reserve(segments_.size() + other.segments_.size());
+    for (std::size_t i = 0; i < other.segments_.size(); ++i) {
+      segments_.emplace(segments_.size(), std::move(other.segments_[i]));
+      iovecs_.emplace(iovecs_.size(), other.iovecs_[i]);
+    }
+    size_ += other.size_;
+    other.clear();
+  }
+
+  /// Owning segment at the front of the chain (ignored if empty)
+  void prepend(shared_buffer<T> buffer) { insert(0, std::move(buffer)); }
+
+  /// Borrowed segment at the front of the chain (ignored if empty)
+  void prepend(buffer_base<T> view) {
+    insert(0, shared_buffer<T>(), view.data(), view.size());
+  }
+
+  /// Takes ownership of a unique_buffer (shared with nothing else)
+  template <typename Deleter>
+  void prepend(unique_buffer<T, Deleter> &&buffer) {
+    prepend(shared_buffer<T>(std::move(buffer)));
+  }
+
+  /**
+   * @brief Detaches the first `count` elements into a new chain.
+   *
+   * A segment straddling the split point is shared by both chains: an
+   * owning segment's refcount is incremented, no data is copied.
+   *
+   * @throws std::out_of_range if `count > size()`.
+   */
+  buffer_chain split(size_type count) {
+    if (count > size_) {
+      throw std::out_of_range("buffer_chain::split: count exceeds size");
+    }
+    buffer_chain head;
+    auto [whole, offset] = locate(count);
+    head.reserve(whole + (offset ? 1 : 0));
+    for (std::size_t i = 0; i < whole; ++i) {
+      head.segments_.emplace(i, std::move(segments_[i]));
+      head.iovecs_.emplace(i, iovecs_[i]);
+    }
+    if (offset) {
+      head.segments_.emplace(whole, segments_[whole]);
+      head.iovecs_.emplace(whole, detail::io_segment{iovecs_[whole].iov_base,
+                                                     offset * sizeof(T)});
+    }
+    head.size_ = count;
+    drop_front(whole, offset);
+    return head;
+  }
+
+  /**
+   * @brief Drops the first `count` elements, e.g. after a partial `writev()`.
+   *
+   * Owning segments that are fully consumed are released immediately.
+   *
+   * @throws std::out_of_range if `count > size()`.
+   */
+  void consume(size_type count) {
+    if (count > size_) {
+      throw std::out_of_range("buffer_chain::consume: count exceeds size");
+    }
+    auto [whole, offset] = locate(count);
+    drop_front(whole, offset);
+  }
+
+  /// Removes every segment
+  void clear() noexcept {
+    segments_.clear();
+    iovecs_.clear();
+    size_ = 0;
+  }
+
+  /// @return Total number of elements across all segments
+  size_type size() const noexcept { return size_; }
+
+  size_type size_bytes() const noexcept { return size_ * sizeof(T); }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type segment_count() const noexcept { return segments_.size(); }
+
+  /// @return Non-owning view of segment `i`
+  buffer_base<T> segment(size_type i) const noexcept {
+    return buffer_base<T>(static_cast<T *>(iovecs_[i].iov_base),
+                          iovecs_[i].iov_len / sizeof(T));
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  /**
+   * @return One iovec per segment, ready for `writev()` / `sendmsg()`. The
+   * caller is responsible for splitting chains longer than `IOV_MAX`.
+   */
+  std::span<const iovec> iovecs() const noexcept {
+    return {iovecs_.data(), iovecs_.size()};
+  }
+#endif
+
+  iterator begin() noexcept { return iterator(iovecs_.data()); }
+  iterator end() noexcept { return iterator(iovecs_.data() + iovecs_.size()); }
+  const_iterator begin() const noexcept {
+    return const_iterator(iovecs_.data());
+  }
+  const_iterator end() const noexcept {
+    return const_iterator(iovecs_.data() + iovecs_.size());
+  }
+
+private:
+  /**
+   * Forward iterator over the elements of all segments. Holds a pointer into
+   * the iovec array and an offset within the current segment.
+   */
+  template <bool Const> class basic_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const T &, T &>;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+
+    basic_iterator() noexcept = default;
+
+    /// iterator -> const_iterator
+    template <bool OtherConst>
+      requires(Const && !OtherConst)
+    basic_iterator(const basic_iterator<OtherConst> &other) noexcept
+        : segment_(other.segment_), offset_(other.offset_) {}
+
+    reference operator*() const noexcept {
+      return static_cast<pointer>(segment_->iov_base)[offset_];
+    }
+
+    pointer operator->() const noexcept { return &**this; }
+
+    basic_iterator &operator++() noexcept {
+      if (++offset_ == segment_->iov_len / sizeof(T)) {
+        ++segment_;
+        offset_ = 0;
+      }
+      return *this;
+    }
+
+    basic_iterator operator++(int) noexcept {
+      basic_iterator out = *this;
+      ++*this;
+      return out;
+    }
+
+    friend bool operator==(const basic_iterator &,
+                           const basic_iterator &) noexcept = default;
+
+  private:
+    friend class buffer_chain;
+    template <bool> friend class basic_iterator;
+
+    explicit basic_iterator(const detail::io_segment *segment) noexcept
+        : segment_(segment) {}
+
+    const detail::io_segment *segment_ = nullptr;
+    std::size_t offset_ = 0;
+  };
+
+  void reserve(std::size_t count) {
+    segments_.reserve(count);
+    iovecs_.reserve(count);
+  }
+
+  void insert(std::size_t pos, shared_buffer<T> buffer) {
+    T *data = buffer.data();
+    std::size_t count = buffer.size();
+    insert(pos, std::move(buffer), data, count);
+  }
+
+  void insert(std::size_t pos, shared_buffer<T> owner, T *data,
+              std::size_t count) {
+    if (data == nullptr || count == 0) {
+      return;
+    }
+    reserve(segments_.size() + 1);
+    segments_.emplace(pos, std::move(owner));
+    iovecs_.emplace(pos, detail::io_segment{data, count * sizeof(T)});
+    size_ += count;
+  }
+
+  /**
+   * @return The number of whole segments in the first `count` elements, and
+   * the number of elements taken from the next segment.
+   */
+  std::pair<std::size_t, std::size_t> locate(std::size_t count) const noexcept {
+    std::size_t i = 0;
+    while (count > 0 && count >= iovecs_[i].iov_len / sizeof(T)) {
+      count -= iovecs_[i].iov_len / sizeof(T);
+      ++i;
+    }
+    return {i, count};
+  }
+
+  /// Drops `whole` segments and `offset` elements of the next one.
+  void drop_front(std::size_t whole, std::size_t offset) noexcept {
+    std::size_t dropped = offset;
+    for (std::size_t i = 0; i < whole; ++i) {
+      dropped += iovecs_[i].iov_len / sizeof(T);
+    }
+    segments_.erase(0, whole);
+    iovecs_.erase(0, whole);
+    if (offset) {
+      detail::io_segment &front = iovecs_[0];
+      front.iov_base = static_cast<T *>(front.iov_base) + offset;
+      front.iov_len -= offset * sizeof(T);
+    }
+    size_ -= dropped;
+  }
+
+  /// Owners, parallel to iovecs_; empty for borrowed segments
+  detail::small_vector<shared_buffer<T>, N> segments_;
+  detail::small_vector<detail::io_segment, N> iovecs_;
+  size_type size_ = 0; ///< Total number of elements
+};
+} // namespace nstd::memory
@@ -3,14 +3,170 @@
 #include "../smart_buffers/buffer_base.hpp"
 #include "../smart_buffers/unique_buffer.hpp"
 #include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
 #include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace nstd::memory {
+/// What a call to `shared_control_block::destroy` must free
+enum class DestroyScope {
+  All,  ///< The data and the block: no weak_buffer observes the block
+  Data, ///< Only the data: the last owner is gone, weak_buffers remain
+  Block ///< Only the block, after `Data`, once the last weak_buffer is gone
+};
+
+/**
+ * Type-erased header of every shared_buffer control block.
+ *
+ * The block knows nothing about the element type: the owning handles carry
+ * the data pointer and size, and `destroy` frees the data and the block once
+ * the last owner is gone. Blocks observed by weak_buffers are freed in two
+ * steps, the data first and the block with the last weak_buffer. Allocators
+ * (e.g. MemPool) embed this header in their own, recycled control blocks and
+ * hand them to shared_buffer through the adopting constructor.
+ */
+struct shared_control_block {
+  std::atomic<std::size_t> ref{1}; ///< Number of owning shared_buffers
+  /// Number of weak_buffers, plus one held collectively by the owners
+  std::atomic<std::size_t> weak{1};
+  /// Set once a `local_refcount` owner was converted to `atomic_refcount`;
+  /// from then on every owner updates `ref` atomically.
+  std::atomic<bool> cross_thread{false};
+  MemoryLocation location = MemoryLocation::Host;
+  /// Frees the data and/or the block; see DestroyScope
+  void (*destroy)(shared_control_block *, DestroyScope) noexcept = nullptr;
+
+  /// Called once `ref` dropped to zero (or by a released buffer's deleter)
+  void release_data() noexcept {
+    // Seeing the owners' own weak reference only means no weak_buffer exists,
+    // and none can be created without an owner: free everything at once.
+    if (weak.load(std::memory_order_acquire) == 1) {
+      destroy(this, DestroyScope::All);
+      return;
+    }
+    destroy(this, DestroyScope::Data);
+    release_weak();
+  }
+
+  /// Drops one weak reference, freeing the block with the last one
+  void release_weak() noexcept {
+    if (weak.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      destroy(this, DestroyScope::Block);
+    }
+  }
+};
+
+namespace concepts {
+/**
+ * Deleters that can supply a ready control block for the data they free, so
+ * converting their unique_buffer to a shared_buffer allocates nothing. The
+ * block must come with `ref` and `weak` at 1 and must free `ptr` through its
+ * `destroy` hook. May throw if no block can be provided.
+ */
+template <typename Deleter, typename T>
+concept ControlBlockProvider = requires(Deleter &deleter, T *ptr) {
+  { deleter.make_control_block(ptr) } -> std::same_as<shared_control_block *>;
+};
+} // namespace concepts
+
+/**
+ * Refcount policy of shared_buffers that may be copied and dropped from any
+ * thread (the default): every update is an atomic read-modify-write.
+ */
+struct atomic_refcount {
+  static void increment(shared_control_block &ctrl) noexcept {
+    ctrl.ref.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Increment unless the count already dropped to zero (weak_buffer::lock)
+  static bool try_increment(shared_control_block &ctrl) noexcept {
+    std::size_t count = ctrl.ref.load(std::memory_order_relaxed);
+    do {
+      if (count == 0) {
+        return false;
+      }
+    } while (!ctrl.ref.compare_exchange_weak(count, count + 1,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
+    return true;
+  }
+
+  /// @return true if the last reference was dropped
+  static bool decrement(shared_control_block &ctrl) noexcept {
+    return ctrl.ref.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+};
+
+/**
+ * Refcount policy of shared_buffers confined to one thread (e.g. a per-shard
+ * event loop): copies and drops are plain increments and decrements, with no
+ * locked instructions.
+ *
+ * All `local_refcount` owners of a block must live on the same thread. To
+ * hand a buffer to another thread, convert it to `atomic_refcount` first: the
+ * conversion flags the control block, and the remaining local owners switch
+ * to atomic updates as well.
+ */
+struct local_refcount {
+  static void increment(shared_control_block &ctrl) noexcept {
+    if (ctrl.cross_thread.load(std::memory_order_relaxed)) {
+      atomic_refcount::increment(ctrl);
+      return;
+    }
+    ctrl.ref.store(ctrl.ref.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  }
+
+  /// Increment unless the count already dropped to zero (weak_buffer::lock)
+  static bool try_increment(shared_control_block &ctrl) noexcept {
+    if (ctrl.cross_thread.load(std::memory_order_relaxed)) {
+      return atomic_refcount::try_increment(ctrl);
+    }
+    std::size_t count = ctrl.ref.load(std::memory_order_relaxed);
+    if (count == 0) {
+      return false;
+    }
+    ctrl.ref.store(count + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// @return true if the last reference was dropped
+  static bool decrement(shared_control_block &ctrl) noexcept {
+    if (ctrl.cross_thread.load(std::memory_order_relaxed)) {
+      return atomic_refcount::decrement(ctrl);
+    }
+    std::size_t prev = ctrl.ref.load(std::memory_order_relaxed);
+    ctrl.ref.store(prev - 1, std::memory_order_relaxed);
+    return prev == 1;
+  }
+};
+
+template <typename T, typename RefCount = atomic_refcount> class shared_buffer;
+template <typename T, typename RefCount = atomic_refcount> class weak_buffer;
+
+/// A shared_buffer confined to one thread; see `local_refcount`.
+template <typename T>
+using local_shared_buffer = shared_buffer<T, local_refcount>;
+
+template <concepts::TriviallyCopyable U, concepts::TriviallyCopyable T,
+          typename RefCount>
+shared_buffer<U, RefCount>
+shared_buffer_cast(shared_buffer<T, RefCount> &&buffer);
+
 /**
  * Reference-counted owning container similer to std::shared_ptr for a
- * contiguous block of data. Thread-safe refcounting is used (via atomic). The
- * control block holds the pointer, the count, the deleter, and the memory
- * location. Copies increment the refcount, moves are cheap.
+ * contiguous block of data. Thread-safe refcounting is used (via atomic)
+ * unless `RefCount` is `local_refcount`. The control block holds the count,
+ * the memory location and the knowledge of how to free the data. Copies
+ * increment the refcount, moves are cheap.
  *
  * Important behaviour:
  * - `release()` can transfer ownership out as a `released_buffer<T>` *only* if
@@ -18,18 +174,22 @@ namespace nstd::memory {
  * returns std::nullopt.
  *
  * Implementation detail:
- * - The control block is allocated by this class (via new). The control block
- * will be destroyed either:
- * * when last owner drops the refcount to zero (then the deleter is invoked),
- * * or when `release()` successfully transfers ownership (the control block
- * is deleted but the deleter is moved into the returned raw_buffer).
+ * - Buffers built from a pointer and a deleter allocate their control block
+ * via new. Allocators may supply their own (see `shared_control_block`). The
+ * control block will be destroyed either:
+ * * when last owner drops the refcount to zero (then the data is freed),
+ * * or when the deleter of the `released_buffer` returned by a successful
+ * `release()` is invoked.
+ *
+ * @tparam RefCount `atomic_refcount` (default) or `local_refcount`.
  */
-template <typename T> class shared_buffer {
+template <typename T, typename RefCount> class shared_buffer {
 public:
   using value_type = T;
   using pointer = T *;
   using size_type = std::size_t;
   using deleter_type = std::function<void(T *)>;
+  using refcount_policy = RefCount;
 
   shared_buffer() noexcept = default;
 
@@ -43,34 +203,78 @@ public:
    * @param loc memory location metadata (host/device/pinned/managed)
    */
   explicit shared_buffer(pointer ptr, size_type size, deleter_type deleter,
-                         MemoryLocation loc = MemoryLocation::Host)
-      : ctrl_(nullptr) {
+                         MemoryLocation loc = MemoryLocation::Host) {
     if (ptr == nullptr || size == 0) {
       /// Empty
       return;
     }
-    ctrl_ = new control_block{ptr, size, std::move(deleter), loc};
+    ctrl_ = new deleter_block(ptr, std::move(deleter), loc);
+    ptr_ = ptr;
+    size_ = size;
   }
 
+  /**
+   * Adopt a control block whose refcount was initialized to 1 by its
+   * allocator. `ctrl->destroy` must free `ptr` and/or the block as asked.
+   *
+   * @param ctrl The control block, or nullptr for an empty buffer.
+   * @param ptr Pointer to `size` elements owned through `ctrl`.
+   * @param size Number of elements.
+   */
+  shared_buffer(shared_control_block *ctrl, pointer ptr,
+                size_type size) noexcept
+      : ctrl_(ctrl), ptr_(ctrl ? ptr : nullptr), size_(ctrl ? size : 0) {}
+
   /**
    * Construct a shared_buffer from an already-released buffer.
    *
    * This is useful for transferring ownership of memory that has been
    * released and may contain deleter information, etc.
    */
-  explicit shared_buffer(released_buffer<T> rb) noexcept
+  explicit shared_buffer(released_buffer<T> rb)
       : shared_buffer(rb.ptr, rb.count, std::move(rb.deleter), rb.location) {}
 
   /**
-   * Construct a shared_buffer from a unique_buffer
+   * Construct a shared_buffer from a unique_buffer (with any deleter type).
+   * A `ControlBlockProvider` deleter (e.g. MemPool's) supplies a recycled
+   * control block; any other deleter is moved into a heap-allocated one.
    */
-  shared_buffer(unique_buffer<T> &&u_b) : shared_buffer(u_b.release()) {}
+  template <typename Deleter>
+  shared_buffer(unique_buffer<T, Deleter> &&u_b)
+      : shared_buffer(adopt_unique(std::move(u_b))) {}
 
   /// Copy semantic: increment refcount
-  shared_buffer(const shared_buffer &other) noexcept {
-    ctrl_ = other.ctrl_;
+  shared_buffer(const shared_buffer &other) noexcept
+      : ctrl_(other.ctrl_), ptr_(other.ptr_), size_(other.size_) {
     if (ctrl_) {
-      ctrl_->ref.fetch_add(1, std::memory_order_relaxed);
+      RefCount::increment(*ctrl_);
+    }
+  }
+
+  /**
+   * Share a thread-confined buffer with other threads.
+   *
+   * Flags the control block so that the remaining `local_refcount` owners
+   * (on the original thread) update the refcount atomically from now on.
+   * The conversion itself must run on the thread that owns `other`.
+   */
+  shared_buffer(const shared_buffer<T, local_refcount> &other) noexcept
+    requires std::is_same_v<RefCount, atomic_refcount>
+      : ctrl_(other.ctrl_), ptr_(other.ptr_), size_(other.size_) {
+    if (ctrl_) {
+      ctrl_->cross_thread.store(true, std::memory_order_relaxed);
+      RefCount::increment(*ctrl_);
+    }
+  }
+
+  /// Moving overload of the `local_refcount` conversion; see above.
+  shared_buffer(shared_buffer<T, local_refcount> &&other) noexcept
+    requires std::is_same_v<RefCount, atomic_refcount>
+      : ctrl_(std::exchange(other.ctrl_, nullptr)),
+        ptr_(std::exchange(other.ptr_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {
+    if (ctrl_) {
+      ctrl_->cross_thread.store(true, std::memory_order_relaxed);
     }
   }
 
@@ -84,26 +288,29 @@ public:
       return *this;
     /// Increment new before decrementing old (strong exception safety, but
     /// noexcept here)
-    control_block *new_ctrl = other.ctrl_;
+    shared_control_block *new_ctrl = other.ctrl_;
     if (new_ctrl) {
-      new_ctrl->ref.fetch_add(1, std::memory_order_relaxed);
+      RefCount::increment(*new_ctrl);
     }
     release_ctrl(); // decrement old (and possibly free)
     ctrl_ = new_ctrl;
+    ptr_ = other.ptr_;
+    size_ = other.size_;
     return *this;
   }
 
   /// Move semantic: steal control block pointer
-  shared_buffer(shared_buffer &&other) noexcept {
-    ctrl_ = other.ctrl_;
-    other.ctrl_ = nullptr;
-  }
+  shared_buffer(shared_buffer &&other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, nullptr)),
+        ptr_(std::exchange(other.ptr_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
 
   shared_buffer &operator=(shared_buffer &&other) noexcept {
     if (this != &other) {
       release_ctrl();
-      ctrl_ = other.ctrl_;
-      other.ctrl_ = nullptr;
+      ctrl_ = std::exchange(other.ctrl_, nullptr);
+      ptr_ = std::exchange(other.ptr_, nullptr);
+      size_ = std::exchange(other.size_, 0);
     }
     return *this;
   }
@@ -111,9 +318,9 @@ public:
   ~shared_buffer() { release_ctrl(); }
 
   /// Observers
-  pointer data() const noexcept { return ctrl_ ? ctrl_->ptr : nullptr; }
+  pointer data() const noexcept { return ptr_; }
 
-  size_type size() const noexcept { return ctrl_ ? ctrl_->size : 0; }
+  size_type size() const noexcept { return size_; }
 
   bool empty() const noexcept { return size() == 0; }
 
@@ -132,6 +339,40 @@ public:
 
   std::span<std::byte> byte_span() const noexcept { return view().byte_span(); }
 
+  /**
+   * Owning sub-range `[offset, offset + count)` of this buffer.
+   *
+   * The slice shares this buffer's control block: no data is copied and the
+   * whole underlying allocation stays alive until the last handle (slice or
+   * not) is dropped.
+   *
+   * @return The slice, or an empty buffer if `count` is 0.
+   * @throws std::out_of_range if the range exceeds `size()`.
+   */
+  shared_buffer slice(size_type offset, size_type count) const {
+    if (offset > size_ || count > size_ - offset) {
+      throw std::out_of_range("shared_buffer::slice: range out of bounds");
+    }
+    if (count == 0) {
+      return {};
+    }
+    shared_buffer out(*this);
+    out.ptr_ += offset;
+    out.size_ = count;
+    return out;
+  }
+
+  /**
+   * Owning sub-range from `offset` to the end of this buffer.
+   * @throws std::out_of_range if `offset > size()`.
+   */
+  shared_buffer slice(size_type offset) const {
+    if (offset > size_) {
+      throw std::out_of_range("shared_buffer::slice: offset out of bounds");
+    }
+    return slice(offset, size_ - offset);
+  }
+
   /**
    * Return current use count (approximate; may be racing)
    * @return current use count (approximate; may be racing)
@@ -143,10 +384,12 @@ public:
 
   /**
    * Release ownership only if this is the unique owner (use_count == 1).
-   * On success, returns a released_buffer<T> containing ptr, count and the
-   * deleter (moved out). After success, this shared_buffer becomes empty and
-   * the control block is destroyed. On failure (multiple owners), returns
-   * nullopt.
+   * For a slice, the released pointer and count describe the slice while
+   * the deleter frees the whole underlying allocation.
+   * On success, returns a released_buffer<T> containing ptr, count and a
+   * deleter that frees the data (and the control block) when invoked. After
+   * success, this shared_buffer becomes empty. On failure (multiple owners),
+   * returns nullopt.
    * @return a released_buffer<T> containing ptr, count and the deleter
    */
   std::optional<released_buffer<T>> release() noexcept {
@@ -154,8 +397,8 @@ public:
       return std::nullopt;
     }
 
-    /// Try to transition from ref==1 -> ref==0 (we will delete the control
-    /// block and move out the deleter). Use a compare_exchange to ensure
+    /// Try to transition from ref==1 -> ref==0 (the control block is then
+    /// owned by the returned deleter). Use a compare_exchange to ensure
     /// atomicity.
     std::size_t expected = 1;
     if (!ctrl_->ref.compare_exchange_strong(expected, 0,
@@ -165,70 +408,273 @@ public:
       return std::nullopt;
     }
     /// We are now the unique owner and have "consumed" the refcount.
-    pointer p = ctrl_->ptr;
-    size_type c = ctrl_->size;
-    MemoryLocation loc = ctrl_->location;
-    deleter_type d = std::move(ctrl_->deleter);
-    /// delete control block (do not call deleter)
-    delete ctrl_;
-    ctrl_ = nullptr;
-    return released_buffer<T>{p, c, std::move(d), loc};
+    /// A single captured pointer fits std::function's small buffer.
+    shared_control_block *ctrl = std::exchange(ctrl_, nullptr);
+    released_buffer<T> out{std::exchange(ptr_, nullptr),
+                           std::exchange(size_, 0),
+                           [ctrl](T *) { ctrl->release_data(); },
+                           ctrl->location};
+    return out;
   }
 
   /**
    * Reset (drop ownership). If this was the last owner, the stored deleter is
    * invoked to free memory. If this was shared, refcount is decremented.
    */
-  void reset() noexcept {
-    release_ctrl();
-    ctrl_ = nullptr;
-  }
+  void reset() noexcept { release_ctrl(); }
 
   /**
    * Swap two shared_buffer objects (noexcept)
    * @param other The other shared_buffer object
    */
-  void swap(shared_buffer &other) noexcept { std::swap(ctrl_, other.ctrl_); }
+  void swap(shared_buffer &other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(ptr_, other.ptr_);
+    std::swap(size_, other.size_);
+  }
 
   explicit operator bool() const noexcept { return ctrl_ != nullptr; }
 
 private:
-  struct control_block {
-    control_block(pointer p, size_type c, deleter_type d,
-                  MemoryLocation loc_val) noexcept
-        : ref(1), ptr(p), size(c), deleter(std::move(d)), location(loc_val) {}
-    std::atomic<std::size_t> ref;
+  template <typename, typename> friend class shared_buffer;
+  template <typename, typename> friend class weak_buffer;
+
+  template <concepts::TriviallyCopyable U, concepts::TriviallyCopyable V,
+            typename Policy>
+  friend shared_buffer<U, Policy>
+  shared_buffer_cast(shared_buffer<V, Policy> &&buffer);
+
+  /// Control block of buffers built from a pointer and a deleter
+  struct deleter_block : shared_control_block {
+    deleter_block(pointer p, deleter_type d, MemoryLocation loc) noexcept
+        : ptr(p), deleter(std::move(d)) {
+      location = loc;
+      destroy = &destroy_block;
+    }
+
+    static void destroy_block(shared_control_block *base,
+                              DestroyScope scope) noexcept {
+      auto *block = static_cast<deleter_block *>(base);
+      if (scope != DestroyScope::Block && block->deleter) {
+        try {
+          block->deleter(block->ptr);
+        } catch (...) {
+          /// swallow exceptions in destructor path
+        }
+      }
+      if (scope != DestroyScope::Data) {
+        delete block;
+      }
+    }
 
     pointer ptr;
-    size_type size;
     deleter_type deleter;
-    MemoryLocation location;
   };
-  control_block *ctrl_ = nullptr;
+
+  template <typename Deleter>
+  static shared_buffer adopt_unique(unique_buffer<T, Deleter> &&u_b) {
+    if constexpr (concepts::ControlBlockProvider<Deleter, T>) {
+      if (u_b.data() != nullptr && u_b.size() != 0) {
+        // On failure `u_b` still owns (and frees) its data.
+        shared_control_block *ctrl =
+            u_b.get_deleter().make_control_block(u_b.data());
+        size_type size = u_b.size();
+        return shared_buffer(ctrl, u_b.release().ptr, size);
+      }
+    }
+    return shared_buffer(u_b.release());
+  }
+
+  shared_control_block *ctrl_ = nullptr;
+  pointer ptr_ = nullptr; ///< Start of the elements this handle refers to
+  size_type size_ = 0;
 
   /**
-   * Decrement the refcount and, if reaching zero, call deleter and delete
-   * block.
+   * Decrement the refcount and, if reaching zero, free the data and the
+   * control block. Leaves this buffer empty.
    */
   void release_ctrl() noexcept {
     if (!ctrl_) {
       return;
     }
 
-    /// If fetch_sub returns 1, *we* were the last owner after decrement.
-    std::size_t prev = ctrl_->ref.fetch_sub(1, std::memory_order_acq_rel);
-    if (prev == 1) {
-      /// last owner: call deleter (if set) then delete control block
-      if (ctrl_->deleter) {
-        try {
-          ctrl_->deleter(ctrl_->ptr);
-        } catch (...) {
-          /// swallow exceptions in destructor path
-        }
-      }
-      delete ctrl_;
+    if (RefCount::decrement(*ctrl_)) {
+      ctrl_->release_data();
     }
     ctrl_ = nullptr;
+    ptr_ = nullptr;
+    size_ = 0;
   }
 };
+
+/**
+ * @brief Reinterprets a shared_buffer's elements as type `U` without copying.
+ *
+ * The result shares the control block (and therefore the refcount and the
+ * deleter) of `buffer`, like `std::reinterpret_pointer_cast`.
+ *
+ * @return A buffer of `size() * sizeof(T) / sizeof(U)` elements; empty if
+ * `buffer` is empty. `buffer` is left empty on success and untouched on
+ * failure.
+ *
+ * @throws std::invalid_argument if the data isn't aligned for `U` or its size
+ * in bytes isn't a multiple of `sizeof(U)`.
+ */
+template <concepts::TriviallyCopyable U, concepts::TriviallyCopyable T,
+          typename RefCount>
+shared_buffer<U, RefCount>
+shared_buffer_cast(shared_buffer<T, RefCount> &&buffer) {
+  if (!buffer) {
+    return {};
+  }
+  std::size_t bytes = buffer.size_ * sizeof(T);
+  if (reinterpret_cast<std::uintptr_t>(buffer.ptr_) % alignof(U) != 0) {
+    throw std::invalid_argument(
+        "shared_buffer_cast: data is misaligned for the target type");
+  }
+  if (bytes % sizeof(U) != 0) {
+    throw std::invalid_argument(
+        "shared_buffer_cast: size is not a multiple of the target type");
+  }
+  auto *ptr = reinterpret_cast<U *>(std::exchange(buffer.ptr_, nullptr));
+  buffer.size_ = 0;
+  return shared_buffer<U, RefCount>(std::exchange(buffer.ctrl_, nullptr), ptr,
+                                    bytes / sizeof(U));
+}
+
+/// Copying overload: the result shares ownership with `buffer`.
+template <concepts::TriviallyCopyable U, concepts::TriviallyCopyable T,
+          typename RefCount>
+shared_buffer<U, RefCount>
+shared_buffer_cast(const shared_buffer<T, RefCount> &buffer) {
+  return shared_buffer_cast<U>(shared_buffer<T, RefCount>(buffer));
+}
+
+/**
+ * Control block sharing one allocation with the elements it owns, laid out as
+ * `[block][padding][T x count]`; see `make_shared_buffer()`.
+ */
+template <typename T> struct inline_control_block : shared_control_block {
+  std::size_t count = 0;     ///< Number of constructed elements
+  std::size_t alignment = 0; ///< Alignment of the elements
+
+  /// @return Byte offset of the elements from the start of the block
+  static constexpr std::size_t data_offset(std::size_t alignment) noexcept {
+    return (sizeof(inline_control_block) + alignment - 1) / alignment *
+           alignment;
+  }
+
+  /// @return Alignment of the whole allocation
+  static constexpr std::size_t
+  allocation_alignment(std::size_t alignment) noexcept {
+    return alignment > alignof(inline_control_block)
+               ? alignment
+               : alignof(inline_control_block);
+  }
+
+  T *data() noexcept {
+    return reinterpret_cast<T *>(reinterpret_cast<std::byte *>(this) +
+                                 data_offset(alignment));
+  }
+
+  /// The elements share the allocation, so a weak_buffer keeps the memory
+  /// (not the elements) alive, as with `std::make_shared`.
+  static void destroy_block(shared_control_block *base,
+                            DestroyScope scope) noexcept {
+    auto *block = static_cast<inline_control_block *>(base);
+    if (scope != DestroyScope::Block) {
+      std::destroy_n(block->data(), block->count);
+    }
+    if (scope != DestroyScope::Data) {
+      std::align_val_t align{allocation_alignment(block->alignment)};
+      block->~inline_control_block();
+      ::operator delete(static_cast<void *>(block), align);
+    }
+  }
+};
+
+namespace detail {
+/**
+ * Allocates an inline_control_block followed by `count` elements, constructed
+ * with `init(first, count)`.
+ */
+template <typename T, typename RefCount, typename Init>
+shared_buffer<T, RefCount> make_inline_shared_buffer(std::size_t count,
+                                                     std::size_t alignment,
+                                                     MemoryLocation loc,
+                                                     Init init) {
+  using block_type = inline_control_block<T>;
+  if (!std::has_single_bit(alignment)) {
+    throw std::invalid_argument(
+        "make_shared_buffer: alignment must be a power of two");
+  }
+  if (count == 0) {
+    return {};
+  }
+  alignment = alignment > alignof(T) ? alignment : alignof(T);
+  std::size_t offset = block_type::data_offset(alignment);
+  if (count > (std::numeric_limits<std::size_t>::max() - offset) / sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+  std::align_val_t align{block_type::allocation_alignment(alignment)};
+  void *memory = ::operator new(offset + count * sizeof(T), align);
+
+  auto *block = ::new (memory) block_type();
+  block->alignment = alignment;
+  try {
+    init(block->data(), count);
+  } catch (...) {
+    block->~block_type();
+    ::operator delete(memory, align);
+    throw;
+  }
+  block->count = count;
+  block->location = loc;
+  block->destroy = &block_type::destroy_block;
+  return shared_buffer<T, RefCount>(block, block->data(), count);
+}
+} // namespace detail
+
+/**
+ * @brief Creates a shared_buffer of `count` value-initialized elements whose
+ * control block lives in the same allocation, like `std::make_shared`.
+ *
+ * One heap allocation instead of two (plus the `std::function` deleter of the
+ * pointer/deleter constructor), and the refcount shares cache lines with the
+ * start of the data.
+ *
+ * @param count Number of elements; 0 yields an empty buffer.
+ * @param alignment Alignment of the first element (power of two, raised to
+ * at least `alignof(T)`).
+ * @param loc Memory location metadata.
+ * @tparam RefCount Refcount policy of the result.
+ *
+ * @throws std::invalid_argument if alignment is not a power of two.
+ * @throws std::bad_alloc if allocation fails.
+ * @throws Whatever T's constructor throws (nothing is leaked).
+ */
+template <typename T, typename RefCount = atomic_refcount>
+shared_buffer<T, RefCount>
+make_shared_buffer(std::size_t count, std::size_t alignment = alignof(T),
+                   MemoryLocation loc = MemoryLocation::Host) {
+  return detail::make_inline_shared_buffer<T, RefCount>(
+      count, alignment, loc, [](T *first, std::size_t n) {
+        std::uninitialized_value_construct_n(first, n);
+      });
+}
+
+/**
+ * @brief Like `make_shared_buffer()` but default-initializes the elements, so
+ * trivially constructible types are left uninitialized (no zeroing pass).
+ */
+template <typename T, typename RefCount = atomic_refcount>
+shared_buffer<T, RefCount>
+make_shared_buffer_for_overwrite(std::size_t count,
+                                 std::size_t alignment = alignof(T),
+                                 MemoryLocation loc = MemoryLocation::Host) {
+  return detail::make_inline_shared_buffer<T, RefCount>(
+      count, alignment, loc, [](T *first, std::size_t n) {
+        std::uninitialized_default_construct_n(first, n);
+      });
+}
 } // namespace nstd::memory
@@ -1,11 +1,49 @@
 #pragma once
 
+#include "../concepts.h"
 #include "buffer_base.hpp"
 #include "released_buffer.hpp"
 
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
 
 namespace nstd::memory {
+template <typename T, typename Deleter> class unique_buffer;
+
+/**
+ * Deleter of a buffer reinterpreted as another element type: converts the
+ * pointer back to the original type and forwards it to the original deleter.
+ *
+ * @tparam From The element type the memory was allocated as.
+ * @tparam Deleter The original deleter.
+ */
+template <typename From, typename Deleter> struct reinterpret_deleter {
+  [[no_unique_address]] Deleter deleter;
+
+  template <typename To> void operator()(To *p) {
+    deleter(reinterpret_cast<From *>(p));
+  }
+
+  /// Empty iff the original deleter is (for deleters that can be empty)
+  explicit operator bool() const noexcept
+    requires std::is_constructible_v<bool, const Deleter &>
+  {
+    return static_cast<bool>(deleter);
+  }
+};
+
+template <concepts::TriviallyCopyable U, concepts::TriviallyCopyable T,
+          typename Deleter>
+unique_buffer<U, reinterpret_deleter<T, Deleter>>
+unique_buffer_cast(unique_buffer<T, Deleter> &&buffer);
 /**
  * Move-only owning container for a contiguous block of T elements, similar to
  * unique_ptr.
@@ -17,13 +55,23 @@ namespace nstd::memory {
  *
  * Usage notes:
  * - This type is intentionally light-weight and has no reference counting.
+ * - The deleter defaults to a type-erased `std::function`. Owners with a fixed
+ * release path (e.g. MemPool) can supply a stateless or pointer-sized callable
+ * instead, which is stored inline and invoked directly.
+ *
+ * @tparam T The element type.
+ * @tparam Deleter Callable invoked as `deleter(ptr)` to free the memory.
  */
-template <typename T> class unique_buffer : public buffer_base<T> {
+template <typename T, typename Deleter = std::function<void(T *)>>
+class unique_buffer;
+
+template <typename T, typename Deleter>
+class unique_buffer : public buffer_base<T> {
 public:
   using value_type = T;
   using pointer = T *;
   using size_type = std::size_t;
-  using deleter_type = std::function<void(T *)>;
+  using deleter_type = Deleter;
 
   /**
    * Default constructs an empty unique_buffer (no ownership).
@@ -37,6 +85,7 @@ public:
    * @param loc Memory location metadata
    */
   unique_buffer(size_type count, MemoryLocation loc = MemoryLocation::Host)
+    requires std::is_constructible_v<deleter_type, void (*)(T *)>
       : buffer_base<T>(new T[count], count, loc),
         deleter_([](T *p) { delete[] p; }) {}
 
@@ -64,9 +113,29 @@ public:
    * released and may contain deleter information, etc.
    */
   explicit unique_buffer(released_buffer<T> rb) noexcept
+    requires std::is_constructible_v<deleter_type, std::function<void(T *)>>
       : buffer_base<T>(rb.ptr, rb.count, rb.location),
         deleter_(std::move(rb.deleter)) {}
 
+  /**
+   * Converting move constructor from a unique_buffer with a different deleter
+   * type, e.g. a pool-owned buffer into the type-erased default.
+   *
+   * Type erasure into `std::function` may allocate, so this is noexcept only
+   * if constructing the deleter is. If it throws, `other` keeps ownership.
+   */
+  template <typename OtherDeleter>
+    requires(!std::is_same_v<OtherDeleter, Deleter> &&
+             std::is_constructible_v<Deleter, OtherDeleter &&>)
+  unique_buffer(unique_buffer<T, OtherDeleter> &&other) noexcept(
+      std::is_nothrow_constructible_v<Deleter, OtherDeleter &&>)
+      : buffer_base<T>(other.data_, other.count_, other.location_),
+        deleter_(std::move(other.deleter_)) {
+    other.data_ = nullptr;
+    other.count_ = 0;
+    other.location_ = MemoryLocation::Host;
+  }
+
   /// Move semantics
   unique_buffer(unique_buffer &&other) noexcept {
     steal_from(std::move(other));
@@ -102,7 +171,7 @@ public:
     this->data_ = nullptr;
     this->count_ = 0;
     this->location_ = MemoryLocation::Host;
-    deleter_ = nullptr;
+    clear_deleter();
     return out;
   }
 
@@ -111,7 +180,7 @@ public:
    */
   void reset() noexcept {
     if (this->data_) {
-      if (deleter_) {
+      if (has_deleter()) {
         // deleter should be noexcept or at least not throw in destructor
         // context
         try {
@@ -124,7 +193,7 @@ public:
       this->count_ = 0;
       this->location_ = MemoryLocation::Host;
     }
-    deleter_ = nullptr;
+    clear_deleter();
   }
 
   /**
@@ -155,6 +224,29 @@ public:
   deleter_type get_deleter() { return deleter_; }
 
 private:
+  template <typename, typename> friend class unique_buffer;
+
+  template <concepts::TriviallyCopyable U, concepts::TriviallyCopyable V,
+            typename OtherDeleter>
+  friend unique_buffer<U, reinterpret_deleter<V, OtherDeleter>>
+  unique_buffer_cast(unique_buffer<V, OtherDeleter> &&buffer);
+
+  /// Deleters that can be empty (std::function, function pointers) are
+  /// checked before invocation; plain callables are always invoked.
+  bool has_deleter() const noexcept {
+    if constexpr (std::is_constructible_v<bool, const deleter_type &>) {
+      return static_cast<bool>(deleter_);
+    } else {
+      return true;
+    }
+  }
+
+  void clear_deleter() noexcept {
+    if constexpr (std::is_assignable_v<deleter_type &, std::nullptr_t>) {
+      deleter_ = nullptr;
+    }
+  }
+
   /**
    * Steal resources from another unique_buffer without copying.
    *
@@ -175,8 +267,130 @@ private:
     other.data_ = nullptr;
     other.count_ = 0;
     other.location_ = MemoryLocation::Host;
-    other.deleter_ = nullptr;
+    other.clear_deleter();
   }
-  deleter_type deleter_;
+  [[no_unique_address]] deleter_type deleter_;
 };
+/**
+ * @brief Reinterprets a unique_buffer's memory as elements of type `U`
+ * without copying.
+ *
+ * The original deleter is kept (wrapped in a `reinterpret_deleter`), so the
+ * memory is still freed as the type it was allocated as.
+ *
+ * @return A buffer of `size_bytes() / sizeof(U)` elements; empty if `buffer`
+ * is empty. `buffer` is left empty on success and untouched on failure.
+ *
+ * @throws std::invalid_argument if the data isn't aligned for `U` or its size
+ * in bytes isn't a multiple of `sizeof(U)`.
+ */
+template <concepts::TriviallyCopyable U, concepts::TriviallyCopyable T,
+          typename Deleter>
+unique_buffer<U, reinterpret_deleter<T, Deleter>>
+unique_buffer_cast(unique_buffer<T, Deleter> &&buffer) {
+  using result_type = unique_buffer<U, reinterpret_deleter<T, Deleter>>;
+  if (!buffer) {
+    return result_type();
+  }
+  std::size_t bytes = buffer.size() * sizeof(T);
+  if (reinterpret_cast<std::uintptr_t>(buffer.get()) % alignof(U) != 0) {
+    throw std::invalid_argument(
+        "unique_buffer_cast: data is misaligned for the target type");
+  }
+  if (bytes % sizeof(U) != 0) {
+    throw std::invalid_argument(
+        "unique_buffer_cast: size is not a multiple of the target type");
+  }
+  result_type out(reinterpret_cast<U *>(buffer.data_), bytes / sizeof(U),
+                  {std::move(buffer.deleter_)}, buffer.location_);
+  buffer.data_ = nullptr;
+  buffer.count_ = 0;
+  buffer.location_ = MemoryLocation::Host;
+  buffer.clear_deleter();
+  return out;
+}
+
+/// How `make_unique_buffer()` initializes the elements
+enum class InitPolicy {
+  Uninitialized, ///< Default-init: trivial types are left untouched
+  Zeroed,        ///< All bytes zero (trivial types only)
+  Value          ///< Value-init, like `new T[count]()`
+};
+
+/**
+ * Deleter of buffers made by `make_unique_buffer()`: destroys the elements
+ * and frees the `std::aligned_alloc` allocation.
+ */
+template <typename T> struct aligned_deleter {
+  std::size_t count = 0; ///< Elements to destroy before freeing
+
+  void operator()(T *p) const noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      std::destroy_n(p, count);
+    }
+    std::free(p);
+  }
+};
+
+/**
+ * @brief Allocates `count` elements aligned to `alignment` bytes, e.g. 64 for
+ * AVX-512 loads, initialized according to `Init`.
+ *
+ * The result converts to `unique_buffer<T>` and `shared_buffer<T>` like any
+ * other unique_buffer.
+ *
+ * @tparam Init How the elements are initialized. `Zeroed` only accepts
+ * trivially default constructible, trivially copyable types.
+ * @param count Number of elements; 0 yields an empty buffer.
+ * @param alignment Alignment of the first element (power of two, raised to
+ * at least `alignof(T)`).
+ * @param loc Memory location metadata.
+ *
+ * @throws std::invalid_argument if alignment is not a power of two.
+ * @throws std::bad_alloc if allocation fails.
+ * @throws Whatever T's constructor throws (nothing is leaked).
+ */
+template <typename T, InitPolicy Init = InitPolicy::Value>
+  requires(Init != InitPolicy::Zeroed ||
+           (std::is_trivially_default_constructible_v<T> &&
+            std::is_trivially_copyable_v<T>))
+unique_buffer<T, aligned_deleter<T>>
+make_unique_buffer(std::size_t count, std::size_t alignment = alignof(T),
+                   MemoryLocation loc = MemoryLocation::Host) {
+  using result_type = unique_buffer<T, aligned_deleter<T>>;
+  if (!std::has_single_bit(alignment)) {
+    throw std::invalid_argument(
+        "make_unique_buffer: alignment must be a power of two");
+  }
+  if (count == 0) {
+    return result_type();
+  }
+  alignment = alignment > alignof(T) ? alignment : alignof(T);
+  if (count > (std::numeric_limits<std::size_t>::max() - alignment) /
+                  sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+  // aligned_alloc requires a size that is a multiple of the alignment.
+  std::size_t bytes = (count * sizeof(T) + alignment - 1) / alignment *
+                      alignment;
+  void *memory = std::aligned_alloc(alignment, bytes);
+  if (!memory) {
+    throw std::bad_alloc();
+  }
+  T *first = static_cast<T *>(memory);
+  try {
+    if constexpr (Init == InitPolicy::Uninitialized) {
+      std::uninitialized_default_construct_n(first, count);
+    } else if constexpr (Init == InitPolicy::Zeroed) {
+      std::memset(memory, 0, count * sizeof(T));
+      std::uninitialized_default_construct_n(first, count);
+    } else {
+      std::uninitialized_value_construct_n(first, count);
+    }
+  } catch (...) {
+    std::free(memory);
+    throw;
+  }
+  return result_type(first, count, aligned_deleter<T>{count}, loc);
+}
 } // namespace nstd::memory
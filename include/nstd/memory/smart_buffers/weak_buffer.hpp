@@ -0,0 +1,108 @@
+#pragma once
+
+#include "shared_buffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace nstd::memory {
+/**
+ * Non-owning observer of a shared_buffer, similar to std::weak_ptr. It keeps
+ * the control block alive (not the data) and can be turned back into an
+ * owning handle with `lock()` as long as some shared_buffer still owns the
+ * data.
+ *
+ * A weak_buffer made from a slice locks into the same slice. Weak counts are
+ * always updated atomically; with `local_refcount`, `lock()` follows the same
+ * thread confinement rules as the owners.
+ *
+ * @warning A weak_buffer to a pool-allocated block refers to the pool's
+ * control block storage: the pool must outlive it, as for the block itself.
+ *
+ * @tparam RefCount Refcount policy of the observed (and locked) buffers.
+ */
+template <typename T, typename RefCount> class weak_buffer {
+public:
+  using value_type = T;
+  using pointer = T *;
+  using size_type = std::size_t;
+
+  weak_buffer() noexcept = default;
+
+  /// Observe `buffer` (empty if `buffer` is empty)
+  weak_buffer(const shared_buffer<T, RefCount> &buffer) noexcept
+      : ctrl_(buffer.ctrl_), ptr_(buffer.ptr_), size_(buffer.size_) {
+    if (ctrl_) {
+      ctrl_->weak.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  weak_buffer(const weak_buffer &other) noexcept
+      : ctrl_(other.ctrl_), ptr_(other.ptr_), size_(other.size_) {
+    if (ctrl_) {
+      ctrl_->weak.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  weak_buffer(weak_buffer &&other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, nullptr)),
+        ptr_(std::exchange(other.ptr_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  weak_buffer &operator=(const weak_buffer &other) noexcept {
+    weak_buffer(other).swap(*this);
+    return *this;
+  }
+
+  weak_buffer &operator=(weak_buffer &&other) noexcept {
+    weak_buffer(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  weak_buffer &operator=(const shared_buffer<T, RefCount> &buffer) noexcept {
+    weak_buffer(buffer).swap(*this);
+    return *this;
+  }
+
+  ~weak_buffer() { reset(); }
+
+  /**
+   * @return An owning handle to the observed data, or an empty buffer if the
+   * last owner is gone.
+   */
+  shared_buffer<T, RefCount> lock() const noexcept {
+    if (!ctrl_ || !RefCount::try_increment(*ctrl_)) {
+      return {};
+    }
+    return shared_buffer<T, RefCount>(ctrl_, ptr_, size_);
+  }
+
+  /// @return true if the data was freed (or nothing is observed)
+  bool expired() const noexcept { return use_count() == 0; }
+
+  /// @return Number of owners of the observed data (approximate; may race)
+  std::size_t use_count() const noexcept {
+    return ctrl_ ? ctrl_->ref.load(std::memory_order_relaxed) : 0;
+  }
+
+  /// Stop observing. Frees the control block if this was the last reference.
+  void reset() noexcept {
+    if (ctrl_) {
+      std::exchange(ctrl_, nullptr)->release_weak();
+      ptr_ = nullptr;
+      size_ = 0;
+    }
+  }
+
+  void swap(weak_buffer &other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(ptr_, other.ptr_);
+    std::swap(size_, other.size_);
+  }
+
+private:
+  shared_control_block *ctrl_ = nullptr;
+  pointer ptr_ = nullptr; ///< Data of the observed handle; never dereferenced
+  size_type size_ = 0;
+};
+} // namespace nstd::memory
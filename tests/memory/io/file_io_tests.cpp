@@ -0,0 +1,140 @@
+#include "nstd/memory/io/file_io.hpp"
+#include "nstd/memory/smart_buffers/shared_buffer.hpp"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace io = nstd::memory::io;
+
+namespace {
+/// Temporary file on the local filesystem, removed on destruction
+class FileIoTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "nstd_file_io_XXXXXX";
+    int fd = ::mkstemp(path_.data());
+    ASSERT_GE(fd, 0);
+    fd_ = io::file_descriptor(fd);
+  }
+
+  void TearDown() override {
+    fd_.close();
+    ::unlink(path_.c_str());
+  }
+
+  /// Fills the file with `size` bytes of a known pattern
+  std::vector<std::byte> fill(std::size_t size) {
+    std::vector<std::byte> data(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      data[i] = static_cast<std::byte>(i * 7 + i / 251);
+    }
+    EXPECT_EQ(io::write_at(fd_.get(), std::span<const std::byte>(data), 0),
+              size);
+    return data;
+  }
+
+  std::string path_;
+  io::file_descriptor fd_;
+};
+} // namespace
+
+TEST_F(FileIoTest, MapWholeFile) {
+  auto expected = fill(3 * 4096 + 123);
+  auto mapped = io::map_file(path_);
+  ASSERT_EQ(mapped.size(), expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), mapped.get()));
+
+  // Shares the mapping; munmap runs when the last owner drops.
+  nstd::memory::shared_buffer<std::byte> shared(std::move(mapped));
+  auto tail = shared.slice(4096);
+  shared.reset();
+  EXPECT_EQ(tail.data()[0], expected[4096]);
+}
+
+TEST_F(FileIoTest, MapUnalignedRangePrivately) {
+  auto expected = fill(10000);
+  auto mapped = io::map_file(fd_.get(), io::MapMode::Private, 5000, 100);
+  ASSERT_EQ(mapped.size(), 100u);
+  EXPECT_EQ(mapped.get()[0], expected[5000]);
+  EXPECT_EQ(mapped.get()[99], expected[5099]);
+
+  // Copy-on-write: the file is unchanged.
+  mapped.get()[0] = std::byte{0};
+  std::byte byte{};
+  EXPECT_EQ(io::read_at(fd_.get(), {&byte, 1}, 5000), 1u);
+  EXPECT_EQ(byte, expected[5000]);
+
+  EXPECT_FALSE(io::map_file(fd_.get(), io::MapMode::ReadOnly, 10000));
+  EXPECT_THROW(io::map_file(fd_.get(), io::MapMode::ReadOnly, 9000, 1001),
+               std::out_of_range);
+  EXPECT_THROW(io::map_file(path_ + ".missing"), std::system_error);
+}
+
+TEST_F(FileIoTest, MappedWordsViaCast) {
+  fill(64);
+  auto words = nstd::memory::unique_buffer_cast<std::uint32_t>(
+      io::map_file(path_));
+  EXPECT_EQ(words.size(), 16u);
+}
+
+TEST_F(FileIoTest, ReadDirect) {
+  auto expected = fill(2 * 4096 + 17);
+  auto buffer = io::read_file_direct(path_);
+  ASSERT_EQ(buffer.size(), expected.size());
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.get()) %
+                io::direct_io_alignment(),
+            0u);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.get()));
+
+  fd_.close();
+  ASSERT_EQ(::truncate(path_.c_str(), 0), 0);
+  EXPECT_FALSE(io::read_file_direct(path_));
+}
+
+TEST_F(FileIoTest, ReadAtStopsAtShortDirectRead) {
+  auto expected = fill(4096 + 100);
+#if defined(O_DIRECT)
+  int fd = ::open(path_.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+  if (fd < 0) {
+    GTEST_SKIP() << "O_DIRECT is not supported here";
+  }
+  io::file_descriptor direct(fd);
+  std::size_t alignment = io::direct_io_alignment();
+  std::size_t capacity = 4 * alignment;
+  io::aligned_buffer buffer(
+      static_cast<std::byte *>(std::aligned_alloc(alignment, capacity)),
+      capacity, nstd::memory::aligned_deleter<std::byte>{});
+  // Ends at EOF after the short read instead of retrying at an unaligned
+  // offset, which O_DIRECT would reject.
+  EXPECT_EQ(io::read_at(direct.get(), {buffer.get(), capacity}, 0),
+            expected.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.get()));
+#else
+  GTEST_SKIP() << "O_DIRECT is not available";
+#endif
+}
+
+TEST_F(FileIoTest, WriteChainWithPwritev) {
+  std::string header = "HEADER";
+  auto payload = nstd::memory::make_shared_buffer<std::byte>(5000);
+  for (std::size_t i = 0; i < payload.size(); ++i) {
+    payload.data()[i] = static_cast<std::byte>('a' + i % 26);
+  }
+
+  nstd::memory::buffer_chain<std::byte, 2> chain;
+  chain.append(nstd::memory::buffer_base<std::byte>(
+      reinterpret_cast<std::byte *>(header.data()), header.size()));
+  // More segments than IOV_MAX exercises the windowing.
+  for (int i = 0; i < 1500; ++i) {
+    chain.append(payload.slice(i % 4000, 3));
+  }
+  ASSERT_EQ(io::write_at(fd_.get(), chain, 100), chain.size_bytes());
+  EXPECT_EQ(io::file_size(fd_.get()), 100 + chain.size_bytes());
+
+  std::vector<std::byte> back(chain.size_bytes());
+  EXPECT_EQ(io::read_at(fd_.get(), back, 100), back.size());
+  EXPECT_TRUE(std::equal(chain.begin(), chain.end(), back.begin()));
+}
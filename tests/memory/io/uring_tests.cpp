@@ -0,0 +1,160 @@
+#include "nstd/memory/io/uring.hpp"
+#include "nstd/memory/mempool/MemPool.hpp"
+#include "nstd/memory/smart_buffers/shared_buffer.hpp"
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace io = nstd::memory::io;
+
+namespace {
+/// Temporary regular file; skips the test where io_uring is unavailable
+class UringTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    if (!io::uring::supported()) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+    path_ = ::testing::TempDir() + "nstd_uring_XXXXXX";
+    int fd = ::mkstemp(path_.data());
+    ASSERT_GE(fd, 0);
+    fd_ = io::file_descriptor(fd);
+  }
+
+  void TearDown() override {
+    if (fd_) {
+      fd_.close();
+      ::unlink(path_.c_str());
+    }
+  }
+
+  std::string path_;
+  io::file_descriptor fd_;
+};
+
+nstd::memory::unique_buffer<char> make_text(const std::string &text) {
+  nstd::memory::unique_buffer<char> ub(text.size());
+  std::memcpy(ub.get(), text.data(), text.size());
+  return ub;
+}
+} // namespace
+
+TEST_F(UringTest, WriteThenReadKeepsBuffersAlive) {
+  io::uring ring(8);
+  auto text = nstd::memory::make_shared_buffer<char>(11);
+  std::memcpy(text.data(), "hello uring", 11);
+  auto written = ring.write(fd_.get(), text, 0);
+  EXPECT_EQ(text.use_count(), 2u); // The ring holds a reference in flight
+  ring.drain();
+  auto done = written.get();
+  EXPECT_EQ(done.result, 11);
+  EXPECT_EQ(done.buffer.data(), text.data());
+  done.buffer.reset();
+  EXPECT_EQ(text.use_count(), 1u);
+
+  nstd::memory::unique_buffer<char> target(11);
+  char *raw = target.get();
+  bool called = false;
+  ring.read(fd_.get(), std::move(target), 0,
+            [&](nstd::memory::unique_buffer<char> back, int result) {
+              called = true;
+              EXPECT_EQ(result, 11);
+              EXPECT_EQ(back.get(), raw);
+              EXPECT_EQ(std::string(back.get(), back.size()), "hello uring");
+            });
+  EXPECT_FALSE(target);
+  EXPECT_EQ(ring.pending(), 1u);
+  EXPECT_EQ(ring.wait(), 1u);
+  EXPECT_TRUE(called);
+  EXPECT_EQ(ring.pending(), 0u);
+}
+
+TEST_F(UringTest, MoreOperationsThanEntries) {
+  io::uring ring(4);
+  constexpr int count = 100;
+  for (int i = 0; i < count; ++i) {
+    ring.write(fd_.get(), make_text(std::string(1, 'a' + i % 26)),
+               static_cast<std::uint64_t>(i),
+               [](nstd::memory::unique_buffer<char>, int result) {
+                 EXPECT_EQ(result, 1);
+               });
+  }
+  ring.drain();
+  EXPECT_EQ(io::file_size(fd_.get()), static_cast<std::uint64_t>(count));
+
+  std::vector<std::future<io::completion<nstd::memory::unique_buffer<char>>>>
+      reads;
+  for (int i = 0; i < count; ++i) {
+    reads.push_back(ring.read(fd_.get(), nstd::memory::unique_buffer<char>(1),
+                              static_cast<std::uint64_t>(i)));
+  }
+  ring.drain();
+  for (int i = 0; i < count; ++i) {
+    auto done = reads[i].get();
+    ASSERT_EQ(done.result, 1);
+    EXPECT_EQ(done.buffer.get()[0], 'a' + i % 26);
+  }
+}
+
+TEST_F(UringTest, ErrorsAreReportedAsNegativeErrno) {
+  io::uring ring(4);
+  auto bad = ring.read(-1, nstd::memory::unique_buffer<char>(4), 0);
+  ring.drain();
+  auto done = bad.get();
+  EXPECT_EQ(done.result, -EBADF);
+  EXPECT_TRUE(done.buffer); // Still handed back
+}
+
+TEST_F(UringTest, DestructorWaitsForInFlightOperations) {
+  bool called = false;
+  {
+    io::uring ring(4);
+    ring.write(fd_.get(), make_text("bye"), 0,
+               [&](nstd::memory::unique_buffer<char>, int result) {
+                 called = true;
+                 EXPECT_EQ(result, 3);
+               });
+  }
+  EXPECT_TRUE(called);
+  EXPECT_EQ(io::file_size(fd_.get()), 3u);
+}
+
+TEST_F(UringTest, FixedBuffersFromMemPool) {
+  nstd::memory::MemPool<char> pool(4096, 4);
+  io::uring ring(8);
+  try {
+    ring.register_pool(pool);
+  } catch (const std::system_error &e) {
+    GTEST_SKIP() << "cannot register fixed buffers: " << e.what();
+  }
+
+  auto out = pool.allocate();
+  std::memset(out.get(), 'x', out.size());
+  auto written = ring.write_fixed(fd_.get(), std::move(out), 0);
+  ring.drain();
+  EXPECT_EQ(written.get().result, 4096);
+  EXPECT_EQ(pool.available(), 4u); // The block went back with the buffer
+
+  auto shared = pool.allocate_shared();
+  auto read = ring.read_fixed(fd_.get(), shared.slice(100, 10), 0);
+  ring.drain();
+  EXPECT_EQ(read.get().result, 10);
+  EXPECT_EQ(shared.data()[100], 'x');
+  EXPECT_EQ(shared.use_count(), 1u);
+
+  // Memory outside the registered slab is rejected before submission, and
+  // the buffer stays with the caller instead of being freed.
+  nstd::memory::MemPool<char> other(64, 1);
+  auto outside = other.allocate();
+  char *data = outside.get();
+  EXPECT_THROW(ring.read_fixed(fd_.get(), std::move(outside), 0),
+               std::invalid_argument);
+  EXPECT_EQ(ring.pending(), 0u);
+  EXPECT_EQ(outside.get(), data);
+  EXPECT_EQ(outside.size(), 64u);
+  EXPECT_EQ(other.available(), 0u);
+  outside.reset();
+  EXPECT_EQ(other.available(), 1u);
+}
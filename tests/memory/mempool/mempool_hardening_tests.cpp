@@ -0,0 +1,124 @@
+// Exercises the hardened debug mode. Built as its own executable
+// (`tests_hardened`) with NSTD_MEMPOOL_HARDENED=1, since the mode must be the
+// same in every translation unit of a program.
+
+#include "nstd/memory/mempool/MemPool.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+
+static_assert(nstd::memory::hardening::enabled,
+              "build this file through the tests_hardened target");
+
+namespace {
+struct Sample {
+  std::uint32_t value;
+};
+
+using SamplePool = nstd::memory::MemPool<Sample>;
+using nstd::memory::hardening::asan;
+
+/// Message of either the pool's own check or ASan's poisoning report
+constexpr const char *write_after_release =
+    "written after release|use-after-poison";
+constexpr const char *overrun = "canary overwritten|use-after-poison";
+} // namespace
+
+TEST(MemPoolHardeningTest, Enabled) {
+  EXPECT_TRUE(nstd::memory::hardening::enabled);
+}
+
+TEST(MemPoolHardeningTest, NormalUsePasses) {
+  SamplePool pool(3, 4);
+  for (int round = 0; round < 3; ++round) {
+    auto a = pool.allocate();
+    auto b = pool.allocate_shared();
+    a.span()[2].value = 1;
+    b.span()[2].value = 2;
+  }
+  EXPECT_EQ(pool.available(), 4u);
+}
+
+TEST(MemPoolHardeningTest, ReleasedBlocksArePoisoned) {
+  SamplePool pool(3, 1);
+  Sample *block = pool.acquire_block();
+  block[0].value = 42;
+  pool.release_block(block);
+
+  Sample *again = pool.acquire_block();
+  ASSERT_EQ(again, block);
+  const auto *bytes = reinterpret_cast<const unsigned char *>(again);
+  for (std::size_t i = 0; i < 3 * sizeof(Sample); ++i) {
+    EXPECT_EQ(bytes[i], nstd::memory::hardening::poison_byte);
+  }
+  pool.release_block(again);
+}
+
+TEST(MemPoolHardeningTest, PoisoningCanBeDisabled) {
+  nstd::memory::MemPoolOptions options;
+  options.poison_released = false;
+  SamplePool pool(3, 1, nstd::memory::MemoryLocation::Host, options);
+  Sample *block = pool.acquire_block();
+  block[0].value = 42;
+  pool.release_block(block);
+
+  Sample *again = pool.acquire_block();
+  EXPECT_EQ(again[0].value, 42u);
+  pool.release_block(again);
+}
+
+TEST(MemPoolHardeningTest, DestroyingWithOutstandingBlocksIsReported) {
+  testing::internal::CaptureStderr();
+  {
+    SamplePool pool(3, 4);
+    pool.acquire_block(); // Never released
+  }
+  std::string report = testing::internal::GetCapturedStderr();
+  EXPECT_NE(report.find("destroyed with outstanding blocks"),
+            std::string::npos);
+  EXPECT_NE(report.find("block 0"), std::string::npos);
+}
+
+TEST(MemPoolHardeningDeathTest, DoubleRelease) {
+  SamplePool pool(3, 2);
+  Sample *block = pool.acquire_block();
+  pool.release_block(block);
+  EXPECT_DEATH(pool.release_block(block), "double release");
+}
+
+TEST(MemPoolHardeningDeathTest, ForeignPointer) {
+  SamplePool pool(3, 2);
+  Sample outside{};
+  EXPECT_DEATH(pool.release_block(&outside), "not owned by this pool");
+}
+
+TEST(MemPoolHardeningDeathTest, PointerInsideBlock) {
+  SamplePool pool(3, 2);
+  Sample *block = pool.acquire_block();
+  EXPECT_DEATH(pool.release_block(block + 1), "not at a block boundary");
+  pool.release_block(block);
+}
+
+TEST(MemPoolHardeningDeathTest, WriteAfterRelease) {
+  SamplePool pool(3, 1);
+  Sample *block = pool.acquire_block();
+  pool.release_block(block);
+  EXPECT_DEATH(
+      {
+        block[1].value = 7;
+        pool.release_block(pool.acquire_block());
+      },
+      write_after_release);
+}
+
+TEST(MemPoolHardeningDeathTest, OverrunIntoPadding) {
+  SamplePool pool(3, 1); // 12 bytes used, 52 bytes of padding
+  Sample *block = pool.acquire_block();
+  EXPECT_DEATH(
+      {
+        block[3].value = 7;
+        pool.release_block(block);
+      },
+      overrun);
+  pool.release_block(block);
+}
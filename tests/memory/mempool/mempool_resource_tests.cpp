@@ -0,0 +1,105 @@
+#include "nstd/memory/mempool/MemPoolResource.hpp"
+#include <gtest/gtest.h>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TEST(MemPoolResourceTest, ServesSmallRequestsFromPool) {
+  nstd::memory::MemPoolResource<> resource(64, 4);
+
+  void *p = resource.allocate(48, 8);
+  EXPECT_TRUE(resource.pool().owns(static_cast<std::byte *>(p)));
+  EXPECT_EQ(resource.pool().available(), 3u);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0u);
+
+  resource.deallocate(p, 48, 8);
+  EXPECT_EQ(resource.pool().available(), 4u);
+  EXPECT_EQ(resource.upstream_allocations(), 0u);
+}
+
+TEST(MemPoolResourceTest, OversizeGoesUpstream) {
+  nstd::memory::MemPoolResource<> resource(64, 4);
+
+  void *p = resource.allocate(1024, 8);
+  EXPECT_FALSE(resource.pool().owns(static_cast<std::byte *>(p)));
+  EXPECT_EQ(resource.pool().available(), 4u);
+  EXPECT_EQ(resource.upstream_allocations(), 1u);
+  resource.deallocate(p, 1024, 8);
+
+  void *q = resource.allocate(16, 128); // over-aligned
+  EXPECT_FALSE(resource.pool().owns(static_cast<std::byte *>(q)));
+  resource.deallocate(q, 16, 128);
+}
+
+TEST(MemPoolResourceTest, ExhaustedPoolFallsBack) {
+  nstd::memory::MemPoolResource<> resource(64, 1);
+
+  void *a = resource.allocate(32, 8);
+  void *b = resource.allocate(32, 8);
+  EXPECT_TRUE(resource.pool().owns(static_cast<std::byte *>(a)));
+  EXPECT_FALSE(resource.pool().owns(static_cast<std::byte *>(b)));
+
+  resource.deallocate(b, 32, 8);
+  resource.deallocate(a, 32, 8);
+  EXPECT_EQ(resource.pool().available(), 1u);
+}
+
+TEST(MemPoolResourceTest, PmrUnorderedMapNodes) {
+  nstd::memory::MemPoolResource<> resource(128, 256);
+  {
+    std::pmr::unordered_map<int, int> map(&resource);
+    for (int i = 0; i < 100; ++i) {
+      map.emplace(i, i * i);
+    }
+    EXPECT_EQ(map.at(9), 81);
+    // Every node lives in the pool; only the bucket array may be larger
+    EXPECT_LE(resource.pool().available(), 256u - 100u);
+  }
+  EXPECT_EQ(resource.pool().available(), 256u);
+}
+
+TEST(MemPoolResourceTest, IsEqual) {
+  nstd::memory::MemPoolResource<> a(64, 1);
+  nstd::memory::MemPoolResource<> b(64, 1);
+  EXPECT_TRUE(a.is_equal(a));
+  EXPECT_FALSE(a.is_equal(b));
+}
+
+TEST(MemPoolAllocatorTest, StdListWithAllocator) {
+  nstd::memory::MemPoolResource<> resource(64, 16);
+  using Alloc = nstd::memory::MemPoolAllocator<int>;
+  {
+    std::list<int, Alloc> list{Alloc(resource)};
+    for (int i = 0; i < 10; ++i) {
+      list.push_back(i);
+    }
+    EXPECT_EQ(list.back(), 9);
+    EXPECT_EQ(resource.pool().available(), 6u);
+  }
+  EXPECT_EQ(resource.pool().available(), 16u);
+}
+
+TEST(MemPoolAllocatorTest, RebindEquality) {
+  nstd::memory::MemPoolResource<> resource(64, 4);
+  nstd::memory::MemPoolResource<> other(64, 4);
+  nstd::memory::MemPoolAllocator<int> a(resource);
+  nstd::memory::MemPoolAllocator<double> b(a);
+  nstd::memory::MemPoolAllocator<int> c(other);
+
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a == c);
+  EXPECT_EQ(b.resource(), &resource);
+}
+
+TEST(MemPoolAllocatorTest, VectorFallsBackWhenLarge) {
+  nstd::memory::MemPoolResource<> resource(64, 4);
+  std::vector<int, nstd::memory::MemPoolAllocator<int>> vec{
+      nstd::memory::MemPoolAllocator<int>(resource)};
+  for (int i = 0; i < 1000; ++i) {
+    vec.push_back(i);
+  }
+  EXPECT_EQ(vec[999], 999);
+  EXPECT_GT(resource.upstream_allocations(), 0u);
+}
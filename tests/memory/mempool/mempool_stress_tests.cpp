@@ -0,0 +1,289 @@
+#include "nstd/memory/mempool/MemPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Multi-producer/multi-consumer stress tests. They are sized to finish
+// quickly under ThreadSanitizer, which is what they are mostly meant for.
+
+namespace {
+constexpr std::size_t stress_threads = 8;
+constexpr std::size_t stress_rounds = 2000;
+
+/// Records which blocks are handed out, to catch a block given out twice
+class ownership_tracker {
+public:
+  explicit ownership_tracker(nstd::memory::MemPool<std::uint64_t> &pool)
+      : stride_(pool.stride()), owned_(pool.capacity()) {
+    // A fresh pool hands out block 0 first; it anchors the index math.
+    std::uint64_t *first = pool.acquire_block();
+    pool.release_block(first);
+    base_ = first;
+  }
+
+  bool claim(const std::uint64_t *block) {
+    return !owned_[index_of(block)].exchange(true, std::memory_order_relaxed);
+  }
+
+  bool drop(const std::uint64_t *block) {
+    return owned_[index_of(block)].exchange(false, std::memory_order_relaxed);
+  }
+
+private:
+  std::size_t index_of(const std::uint64_t *block) const {
+    return static_cast<std::size_t>(block - base_) / stride_;
+  }
+
+  const std::uint64_t *base_ = nullptr;
+  std::size_t stride_;
+  std::vector<std::atomic<bool>> owned_;
+};
+
+/// Unbounded blocking queue used to move blocks between threads
+template <typename Item> class handoff_queue {
+public:
+  void push(Item item) {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      items_.push_back(std::move(item));
+    }
+    ready_.notify_one();
+  }
+
+  bool pop(Item &out) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    ready_.wait(lock, [this] { return !items_.empty() || closed_; });
+    if (items_.empty()) {
+      return false;
+    }
+    out = std::move(items_.front());
+    items_.pop_front();
+    return true;
+  }
+
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      closed_ = true;
+    }
+    ready_.notify_all();
+  }
+
+private:
+  std::mutex mtx_;
+  std::condition_variable ready_;
+  std::deque<Item> items_;
+  bool closed_ = false;
+};
+} // namespace
+
+TEST(MemPoolStressTest, SymmetricBatches) {
+  nstd::memory::MemPoolOptions options;
+  options.collect_stats = true;
+  nstd::memory::MemPool<std::uint64_t> pool(
+      8, 32, nstd::memory::MemoryLocation::Host, options);
+  ownership_tracker tracker(pool);
+
+  std::atomic<std::size_t> errors{0};
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < stress_threads; ++t) {
+    threads.emplace_back([&, t] {
+      std::vector<std::uint64_t *> held;
+      for (std::size_t round = 0; round < stress_rounds; ++round) {
+        std::size_t batch = 1 + (round + t) % 4;
+        for (std::size_t i = 0; i < batch; ++i) {
+          std::uint64_t *block = pool.acquire_block();
+          if (!block) {
+            break; // Other threads hold the rest; not an error
+          }
+          if (!tracker.claim(block)) {
+            ++errors;
+          }
+          std::fill(block, block + 8, t);
+          held.push_back(block);
+        }
+        for (std::uint64_t *block : held) {
+          if (block[7] != t || !tracker.drop(block)) {
+            ++errors;
+          }
+          pool.release_block(block);
+        }
+        held.clear();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(errors.load(), 0u);
+  EXPECT_EQ(pool.available(), pool.capacity());
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocations, stats.releases);
+  EXPECT_EQ(stats.in_use, 0u);
+  EXPECT_LE(stats.peak_in_use, pool.capacity());
+}
+
+TEST(MemPoolStressTest, CrossThreadRelease) {
+  nstd::memory::MemPool<int> pool(16, 16);
+  handoff_queue<nstd::memory::MemPool<int>::buffer_type> queue;
+  constexpr std::size_t producers = stress_threads / 2;
+  std::atomic<std::size_t> consumed{0};
+  std::atomic<std::size_t> corrupted{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (std::size_t round = 0; round < stress_rounds; ++round) {
+        nstd::memory::MemPool<int>::buffer_type buf;
+        while (!buf) {
+          try {
+            buf = pool.allocate();
+          } catch (const std::runtime_error &) {
+            std::this_thread::yield(); // Consumers are behind
+          }
+        }
+        std::fill(buf.span().begin(), buf.span().end(), static_cast<int>(p));
+        queue.push(std::move(buf));
+      }
+    });
+  }
+  for (std::size_t c = 0; c < stress_threads - producers; ++c) {
+    threads.emplace_back([&] {
+      nstd::memory::MemPool<int>::buffer_type buf;
+      while (queue.pop(buf)) {
+        if (buf.span()[0] != buf.span()[15]) {
+          ++corrupted;
+        }
+        buf.reset(); // Released on a different thread than it was taken
+        ++consumed;
+      }
+    });
+  }
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads[p].join();
+  }
+  queue.close();
+  for (std::size_t c = producers; c < threads.size(); ++c) {
+    threads[c].join();
+  }
+
+  EXPECT_EQ(consumed.load(), producers * stress_rounds);
+  EXPECT_EQ(corrupted.load(), 0u);
+  EXPECT_EQ(pool.available(), pool.capacity());
+}
+
+TEST(MemPoolStressTest, SharedFanOutAcrossThreads) {
+  nstd::memory::MemPool<int> pool(4, 8);
+  handoff_queue<nstd::memory::shared_buffer<int>> queue;
+  constexpr std::size_t readers = stress_threads - 1;
+  std::atomic<std::size_t> seen{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t r = 0; r < readers; ++r) {
+    threads.emplace_back([&] {
+      nstd::memory::shared_buffer<int> buf;
+      while (queue.pop(buf)) {
+        seen += static_cast<std::size_t>(buf.span()[3]);
+        buf.reset();
+      }
+    });
+  }
+  for (std::size_t round = 0; round < stress_rounds; ++round) {
+    nstd::memory::shared_buffer<int> buf;
+    while (!buf) {
+      try {
+        buf = pool.allocate_shared();
+      } catch (const std::runtime_error &) {
+        std::this_thread::yield();
+      }
+    }
+    buf.span()[3] = 1;
+    for (std::size_t r = 0; r < readers; ++r) {
+      queue.push(buf);
+    }
+  }
+  queue.close();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(seen.load(), readers * stress_rounds);
+  EXPECT_EQ(pool.available(), pool.capacity());
+}
+
+TEST(MemPoolStressTest, DrainWhileReleasing) {
+  for (std::size_t round = 0; round < 50; ++round) {
+    nstd::memory::MemPool<int> pool(4, stress_threads);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < stress_threads; ++t) {
+      threads.emplace_back([buf = pool.allocate()]() mutable {
+        buf.span()[0] = 1;
+        buf.reset();
+      });
+    }
+    pool.drain();
+    EXPECT_EQ(pool.available(), pool.capacity());
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+}
+
+namespace {
+/// Default constructor that throws while `fail` is set, raising `throwing`
+/// just before it does
+struct FallibleItem {
+  static inline std::atomic<bool> fail{false};
+  static inline std::atomic<bool> throwing{false};
+  FallibleItem() {
+    if (fail.load(std::memory_order_relaxed)) {
+      throwing.store(true, std::memory_order_release);
+      throw std::runtime_error("FallibleItem");
+    }
+  }
+};
+} // namespace
+
+TEST(MemPoolStressTest, SpscRingLazyFailureRacesRelease) {
+  // A failed lazy construction gives its block back while the consumer
+  // releases the only other outstanding one; whichever decrement comes last
+  // must wake drain().
+  nstd::memory::MemPoolOptions options;
+  options.recycling = nstd::memory::RecyclingPolicy::SpscRing;
+  options.lazy_construction = true;
+  options.collect_stats = true; // Widens the release fast path
+  for (std::size_t round = 0; round < stress_rounds / 2; ++round) {
+    nstd::memory::MemPool<FallibleItem> pool(
+        1, 2, nstd::memory::MemoryLocation::Host, options);
+    FallibleItem::fail = false;
+    FallibleItem::throwing = false;
+    auto buf = pool.allocate();
+    FallibleItem::fail = true;
+    std::thread consumer([buf = std::move(buf), round]() mutable {
+      while (!FallibleItem::throwing.load(std::memory_order_acquire)) {
+      }
+      // Sweep the release across the unwinding of the failed construction.
+      volatile std::size_t spin = 0;
+      while (spin < round % 256 * 16) {
+        spin = spin + 1;
+      }
+      buf.reset();
+    });
+    std::thread drainer([&pool] { pool.drain(); });
+    // Give drain() time to start waiting, so a lost wakeup hangs it.
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    EXPECT_THROW(pool.allocate(), std::runtime_error);
+    drainer.join();
+    consumer.join();
+    EXPECT_EQ(pool.available(), pool.capacity());
+  }
+  FallibleItem::fail = false;
+}
@@ -1,7 +1,21 @@
 #include "nstd/memory/mempool/MemPool.hpp"
+#include "nstd/memory/smart_buffers/shared_buffer.hpp"
+#include "nstd/memory/smart_buffers/weak_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
 #include <future>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <gtest/gtest.h>
 
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
 TEST(MemPoolTest, ConstructWithValidArgs) {
   nstd::memory::MemPool<int> pool(1024, 4);
   EXPECT_EQ(pool.capacity(), 4u);
@@ -135,4 +149,766 @@ TEST(MemPoolTest, LargeAlignment) {
   };
   EXPECT_TRUE(check(b1.get())) << "b1 not aligned to 4096";
   EXPECT_TRUE(check(b2.get())) << "b2 not aligned to 4096";
+
+  // Block alignment comes from the slab; the pool object itself only needs
+  // cache-line alignment.
+  static_assert(alignof(nstd::memory::MemPool<double, Align>) == 64);
+}
+
+TEST(MemPoolTest, PointerSizedDeleter) {
+  using Pool = nstd::memory::MemPool<int>;
+  static_assert(sizeof(Pool::buffer_type) ==
+                sizeof(nstd::memory::buffer_base<int>) + sizeof(Pool *));
+
+  Pool pool(16, 2);
+  {
+    Pool::buffer_type b = pool.allocate();
+    EXPECT_EQ(pool.available(), 1u);
+  }
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(MemPoolTest, ConvertToSharedBuffer) {
+  nstd::memory::MemPool<int> pool(16, 1);
+  {
+    nstd::memory::shared_buffer<int> sb(pool.allocate());
+    auto copy = sb;
+    EXPECT_EQ(pool.available(), 0u);
+    EXPECT_EQ(copy.size(), 16u);
+  }
+  EXPECT_EQ(pool.available(), 1u);
+}
+
+TEST(MemPoolTest, NumaNodeListParsing) {
+  using nstd::memory::numa::detail::parse_node_list;
+  using ids = std::vector<std::size_t>;
+  EXPECT_EQ(parse_node_list("0\n"), ids({0}));
+  EXPECT_EQ(parse_node_list("0-3"), ids({0, 1, 2, 3}));
+  // Sparse topologies: node 1 is offline and must not be reported.
+  EXPECT_EQ(parse_node_list("0,2"), ids({0, 2}));
+  EXPECT_EQ(parse_node_list("0,2-3,8"), ids({0, 2, 3, 8}));
+  EXPECT_TRUE(parse_node_list("").empty());
+}
+
+TEST(MemPoolTest, NumaAwareFallback) {
+  nstd::memory::MemPoolOptions options;
+  options.numa_aware = true;
+  nstd::memory::MemPool<int> pool(64, 8, nstd::memory::MemoryLocation::Host,
+                                  options);
+
+  EXPECT_GE(pool.node_count(), 1u);
+  EXPECT_LE(pool.node_count(), nstd::memory::numa::node_count());
+  const auto &online = nstd::memory::numa::online_nodes();
+  auto is_online = [&online](std::size_t node) {
+    return std::find(online.begin(), online.end(), node) != online.end();
+  };
+  EXPECT_TRUE(is_online(nstd::memory::numa::current_node()));
+  EXPECT_TRUE(is_online(nstd::memory::numa::cached_current_node()));
+
+  std::vector<nstd::memory::unique_buffer<int>> bufs;
+  for (int i = 0; i < 8; ++i) {
+    auto buf = pool.allocate();
+    EXPECT_TRUE(is_online(pool.node_of(buf.get())));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buf.get()) % 64, 0u);
+    bufs.push_back(std::move(buf));
+  }
+  EXPECT_EQ(pool.available(), 0u);
+  EXPECT_THROW(pool.allocate(), std::runtime_error);
+
+  bufs.clear();
+  EXPECT_EQ(pool.available(), 8u);
+}
+
+TEST(MemPoolTest, NumaBindDegradesGracefully) {
+  // Ranges smaller than a page cannot be bound and must be rejected quietly.
+  alignas(64) char small[64];
+  EXPECT_FALSE(nstd::memory::numa::bind_to_node(small, sizeof(small), 0));
+  EXPECT_FALSE(nstd::memory::numa::bind_to_node(small, sizeof(small), 4096));
+}
+
+TEST(MemPoolTest, DefaultHeapBacking) {
+  nstd::memory::MemPool<int> pool(64, 2);
+  EXPECT_EQ(pool.backing(), nstd::memory::SlabBacking::Heap);
+  EXPECT_FALSE(pool.memory_locked());
+}
+
+TEST(MemPoolTest, MmapBacking) {
+  nstd::memory::MemPoolOptions options;
+  options.backing = nstd::memory::SlabBacking::Mmap;
+  options.populate = true;
+  nstd::memory::MemPool<double, 128> pool(
+      100, 16, nstd::memory::MemoryLocation::Host, options);
+
+#if defined(__linux__)
+  EXPECT_EQ(pool.backing(), nstd::memory::SlabBacking::Mmap);
+#endif
+  auto b = pool.allocate();
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.get()) % 128, 0u);
+  std::fill(b.span().begin(), b.span().end(), 1.0);
+  EXPECT_EQ(b.span()[99], 1.0);
+}
+
+#if defined(__linux__)
+namespace {
+// Sanitizer runtimes intercept mlock() and turn it into a no-op that
+// reports success, so VmLck can't be cross-checked under them.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+constexpr bool mlock_intercepted = true;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) ||    \
+    __has_feature(memory_sanitizer)
+constexpr bool mlock_intercepted = true;
+#else
+constexpr bool mlock_intercepted = false;
+#endif
+#else
+constexpr bool mlock_intercepted = false;
+#endif
+
+/// First number in `path`, or -1 if it can't be read
+long read_proc_number(const char *path) {
+  std::ifstream in(path);
+  long value = -1;
+  in >> value;
+  return in ? value : -1;
+}
+
+/// VmLck of this process in KiB, or -1
+long locked_kib() {
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.rfind("VmLck:", 0) == 0) {
+      return std::stol(line.substr(6));
+    }
+  }
+  return -1;
+}
+} // namespace
+#endif
+
+TEST(MemPoolTest, HugePageBackingFallsBack) {
+  nstd::memory::MemPoolOptions options;
+  options.backing = nstd::memory::SlabBacking::HugePages;
+  options.lock_memory = true;
+  nstd::memory::MemPool<char> pool(4096, 4, nstd::memory::MemoryLocation::Host,
+                                   options);
+
+  auto b = pool.allocate();
+  b.span()[4095] = 'x';
+  EXPECT_EQ(b.span()[4095], 'x');
+
+#if defined(__linux__)
+  // Anonymous mmap always works, so the fallback never reaches the heap, and
+  // hugetlb pages can only be obtained if the kernel has some reserved.
+  EXPECT_NE(pool.backing(), nstd::memory::SlabBacking::Heap);
+  if (read_proc_number("/proc/sys/vm/nr_hugepages") == 0 &&
+      read_proc_number("/proc/sys/vm/nr_overcommit_hugepages") == 0) {
+    EXPECT_NE(pool.backing(), nstd::memory::SlabBacking::HugePages);
+  }
+
+  // memory_locked() must agree with the kernel's view of this process.
+  rlimit limit{};
+  if (::getrlimit(RLIMIT_MEMLOCK, &limit) == 0 &&
+      limit.rlim_cur == RLIM_INFINITY) {
+    EXPECT_TRUE(pool.memory_locked());
+  }
+  if (pool.memory_locked() && !mlock_intercepted) {
+    EXPECT_GE(locked_kib(), static_cast<long>(4 * 4096 / 1024));
+  }
+#endif
+}
+
+TEST(MemPoolTest, SlabMoveTransfersOwnership) {
+  nstd::memory::slab a(8192, 64, nstd::memory::SlabBacking::Mmap);
+  void *data = a.data();
+  nstd::memory::slab b(std::move(a));
+  EXPECT_EQ(a.data(), nullptr);
+  EXPECT_EQ(b.data(), data);
+  EXPECT_GE(b.size(), 8192u);
+  b.reset();
+  EXPECT_EQ(b.data(), nullptr);
+}
+
+namespace {
+struct Counted {
+  static inline std::atomic<int> alive{0};
+  static constexpr int unlimited = 1 << 30;
+  /// Number of constructions that may still succeed before one throws
+  static inline std::atomic<int> budget{unlimited};
+  int value = 7;
+  Counted() {
+    if (budget.fetch_sub(1) <= 0) {
+      throw std::runtime_error("Counted construction failed");
+    }
+    ++alive;
+  }
+  ~Counted() { --alive; }
+};
+} // namespace
+
+TEST(MemPoolTest, EagerConstruction) {
+  Counted::alive = 0;
+  {
+    nstd::memory::MemPool<Counted> pool(4, 3);
+    EXPECT_EQ(Counted::alive, 12);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(MemPoolTest, LazyConstruction) {
+  Counted::alive = 0;
+  nstd::memory::MemPoolOptions options;
+  options.lazy_construction = true;
+  {
+    nstd::memory::MemPool<Counted> pool(
+        4, 3, nstd::memory::MemoryLocation::Host, options);
+    EXPECT_EQ(Counted::alive, 0);
+    EXPECT_EQ(pool.available(), 3u);
+
+    {
+      auto b = pool.allocate();
+      EXPECT_EQ(Counted::alive, 4);
+      EXPECT_EQ(b.span()[3].value, 7);
+    }
+    // Recycled blocks stay constructed and are not constructed again
+    auto b = pool.allocate();
+    EXPECT_EQ(Counted::alive, 4);
+    auto c = pool.allocate();
+    EXPECT_EQ(Counted::alive, 8);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(MemPoolTest, LazyConstructionFailureKeepsBlock) {
+  Counted::alive = 0;
+  nstd::memory::MemPoolOptions options;
+  options.lazy_construction = true;
+  {
+    nstd::memory::MemPool<Counted> pool(
+        2, 2, nstd::memory::MemoryLocation::Host, options);
+    Counted::budget = 1;
+    EXPECT_THROW(pool.allocate(), std::runtime_error);
+    EXPECT_EQ(Counted::alive, 0);
+    EXPECT_EQ(pool.available(), 2u);
+
+    Counted::budget = Counted::unlimited;
+    auto a = pool.allocate();
+    auto b = pool.allocate();
+    EXPECT_EQ(Counted::alive, 4);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(MemPoolTest, ParallelConstruction) {
+  Counted::alive = 0;
+  nstd::memory::MemPoolOptions options;
+  options.init_threads = 4;
+  options.populate = true;
+  {
+    nstd::memory::MemPool<Counted> pool(
+        16, 64, nstd::memory::MemoryLocation::Host, options);
+    EXPECT_EQ(Counted::alive, 16 * 64);
+    auto b = pool.allocate();
+    EXPECT_EQ(b.span()[15].value, 7);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(MemPoolTest, ParallelConstructionRollback) {
+  Counted::alive = 0;
+  Counted::budget = 100;
+  nstd::memory::MemPoolOptions options;
+  options.init_threads = 4;
+  EXPECT_THROW((nstd::memory::MemPool<Counted>(
+                   16, 64, nstd::memory::MemoryLocation::Host, options)),
+               std::runtime_error);
+  EXPECT_EQ(Counted::alive, 0);
+  Counted::budget = Counted::unlimited;
+}
+
+TEST(MemPoolTest, StatsDisabledByDefault) {
+  nstd::memory::MemPool<int> pool(16, 4);
+  EXPECT_FALSE(pool.stats_enabled());
+
+  auto b = pool.allocate();
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.in_use, 1u);
+  EXPECT_EQ(stats.allocations, 0u);
+}
+
+TEST(MemPoolTest, StatsCounters) {
+  nstd::memory::MemPoolOptions options;
+  options.collect_stats = true;
+  nstd::memory::MemPool<int> pool(16, 2, nstd::memory::MemoryLocation::Host,
+                                  options);
+  ASSERT_TRUE(pool.stats_enabled());
+
+  {
+    auto a = pool.allocate();
+    auto b = pool.allocate();
+    EXPECT_THROW(pool.allocate(), std::runtime_error);
+    EXPECT_EQ(pool.stats().in_use, 2u);
+  }
+  auto c = pool.allocate();
+
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocations, 3u);
+  EXPECT_EQ(stats.releases, 2u);
+  EXPECT_EQ(stats.failed_allocations, 1u);
+  EXPECT_EQ(stats.in_use, 1u);
+  EXPECT_EQ(stats.peak_in_use, 2u);
+  EXPECT_EQ(stats.local_hits + stats.remote_hits, 3u);
+
+  std::uint64_t recorded = 0;
+  for (auto count : stats.acquire_latency) {
+    recorded += count;
+  }
+  EXPECT_EQ(recorded, 3u);
+  EXPECT_GT(stats.latency_percentile_ns(0.99), 0u);
+  EXPECT_LE(stats.latency_percentile_ns(0.5),
+            stats.latency_percentile_ns(0.99));
+}
+
+TEST(MemPoolTest, StatsPercentiles) {
+  nstd::memory::MemPoolStats stats;
+  EXPECT_EQ(stats.latency_percentile_ns(0.5), 0u);
+
+  stats.acquire_latency[4] = 90; // < 16ns
+  stats.acquire_latency[10] = 10; // < 1024ns
+  EXPECT_EQ(stats.latency_percentile_ns(0.5), 16u);
+  EXPECT_EQ(stats.latency_percentile_ns(0.9), 1024u);
+  EXPECT_EQ(stats.latency_percentile_ns(1.0), 1024u);
+}
+
+TEST(MemPoolTest, StatsUnderContention) {
+  nstd::memory::MemPoolOptions options;
+  options.collect_stats = true;
+  nstd::memory::MemPool<char> pool(64, 4, nstd::memory::MemoryLocation::Host,
+                                   options);
+
+  std::vector<std::future<void>> futures;
+  for (int t = 0; t < 4; ++t) {
+    futures.push_back(std::async(std::launch::async, [&pool]() {
+      for (int i = 0; i < 1000; ++i) {
+        auto buf = pool.allocate();
+      }
+    }));
+  }
+  for (auto &f : futures)
+    f.wait();
+
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocations, 4000u);
+  EXPECT_EQ(stats.releases, 4000u);
+  EXPECT_EQ(stats.in_use, 0u);
+  EXPECT_LE(stats.peak_in_use, 4u);
+  EXPECT_EQ(pool.available(), 4u);
+}
+
+TEST(MemPoolTest, OutstandingBlocks) {
+  nstd::memory::MemPool<int> pool(16, 130);
+  EXPECT_TRUE(pool.outstanding_blocks().empty());
+  EXPECT_TRUE(pool.leak_report().empty());
+
+  std::vector<nstd::memory::unique_buffer<int>> bufs;
+  for (int i = 0; i < 130; ++i) {
+    bufs.push_back(pool.allocate());
+  }
+  bufs.erase(bufs.begin() + 1, bufs.begin() + 129); // keep blocks 0 and 129
+
+  std::vector<std::size_t> expected{0, 129};
+  EXPECT_EQ(pool.outstanding_blocks(), expected);
+  auto report = pool.leak_report();
+  EXPECT_NE(report.find("2 outstanding"), std::string::npos);
+  EXPECT_NE(report.find("block 129"), std::string::npos);
+}
+
+TEST(MemPoolTest, DrainWaitsForOutstandingBlocks) {
+  nstd::memory::MemPool<int> pool(16, 2);
+  auto buf = pool.allocate();
+
+  EXPECT_FALSE(pool.drain_for(std::chrono::milliseconds(10)));
+
+  auto releaser =
+      std::async(std::launch::async, [b = std::move(buf)]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        b.reset();
+      });
+  pool.drain();
+  EXPECT_EQ(pool.available(), 2u);
+  releaser.wait();
+  EXPECT_TRUE(pool.drain_for(std::chrono::milliseconds(0)));
+}
+
+TEST(MemPoolTest, SharedPoolOutlivesHandle) {
+  Counted::alive = 0;
+  nstd::memory::unique_buffer<Counted> survivor;
+  {
+    auto pool = nstd::memory::MemPool<Counted>::create_shared(4, 2);
+    survivor = pool->allocate();
+    EXPECT_EQ(Counted::alive, 8);
+  }
+  // The pool handle is gone, but the block (and its slab) are still valid
+  EXPECT_EQ(survivor.span()[3].value, 7);
+  EXPECT_EQ(Counted::alive, 8);
+
+  survivor.reset(); // Last block released -> pool destroyed
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(MemPoolTest, SharedPoolIdleDestruction) {
+  Counted::alive = 0;
+  {
+    auto pool = nstd::memory::MemPool<Counted>::create_shared(4, 2);
+    auto b = pool->allocate();
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(MemPoolTest, CacheLineAlignedLayout) {
+  using Pool = nstd::memory::MemPool<float>;
+  EXPECT_GE(alignof(Pool), Pool::cache_line_size);
+  EXPECT_EQ(sizeof(Pool) % Pool::cache_line_size, 0u);
+
+  // Heap-allocated pools honour the over-alignment too.
+  auto pool = Pool::create_shared(16, 2);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(pool.get()) %
+                Pool::cache_line_size,
+            0u);
+}
+
+TEST(MemPoolTest, Avoid4kAliasingPadsStride) {
+  nstd::memory::MemPool<float> plain(1024, 4);
+  EXPECT_EQ(plain.stride() * sizeof(float), 4096u);
+
+  nstd::memory::MemPoolOptions options;
+  options.avoid_4k_aliasing = true;
+  nstd::memory::MemPool<float> padded(1024, 4,
+                                      nstd::memory::MemoryLocation::Host,
+                                      options);
+  EXPECT_EQ(padded.stride() * sizeof(float), 4096u + 64u);
+
+  auto a = padded.allocate();
+  auto b = padded.allocate();
+  auto distance = reinterpret_cast<std::uintptr_t>(b.get()) -
+                  reinterpret_cast<std::uintptr_t>(a.get());
+  EXPECT_NE(distance % 4096, 0u);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.get()) % 64, 0u);
+  EXPECT_EQ(a.size(), 1024u);
+
+  // Geometries that don't alias are left untouched.
+  nstd::memory::MemPool<float> odd(1000, 4, nstd::memory::MemoryLocation::Host,
+                                   options);
+  EXPECT_EQ(odd.stride(), 1008u);
+}
+
+TEST(MemPoolTest, AllocateShared) {
+  nstd::memory::MemPool<int> pool(16, 2);
+  {
+    auto sb = pool.allocate_shared();
+    EXPECT_EQ(sb.size(), 16u);
+    EXPECT_EQ(sb.use_count(), 1u);
+    EXPECT_TRUE(pool.owns(sb.data()));
+    sb.span()[15] = 42;
+
+    auto copy = sb;
+    auto other = copy;
+    EXPECT_EQ(sb.use_count(), 3u);
+    EXPECT_EQ(other.span()[15], 42);
+    EXPECT_EQ(pool.available(), 1u);
+
+    sb.reset();
+    copy.reset();
+    EXPECT_EQ(pool.available(), 1u); // `other` still holds the block
+  }
+  EXPECT_EQ(pool.available(), 2u);
+
+  auto a = pool.allocate_shared();
+  auto b = pool.allocate_shared();
+  EXPECT_THROW(pool.allocate_shared(), std::runtime_error);
+  EXPECT_NE(a.data(), b.data());
+}
+
+TEST(MemPoolTest, AllocateSharedLocalRefcount) {
+  nstd::memory::MemPool<int> pool(8, 1);
+  {
+    auto sb = pool.allocate_shared<nstd::memory::local_refcount>();
+    auto copy = sb;
+    EXPECT_EQ(sb.use_count(), 2u);
+    nstd::memory::shared_buffer<int> shared = std::move(copy);
+    EXPECT_EQ(sb.use_count(), 2u);
+  }
+  EXPECT_EQ(pool.available(), 1u);
+
+  // The recycled control block starts out thread-local again.
+  auto sb = pool.allocate_shared<nstd::memory::local_refcount>();
+  auto copy = sb;
+  EXPECT_EQ(sb.use_count(), 2u);
+}
+
+TEST(MemPoolTest, AllocateSharedReleaseHandsBlockBack) {
+  nstd::memory::MemPool<int> pool(8, 1);
+  auto sb = pool.allocate_shared();
+  int *data = sb.data();
+
+  auto released = sb.release();
+  ASSERT_TRUE(released.has_value());
+  EXPECT_EQ(released->ptr, data);
+  EXPECT_EQ(pool.available(), 0u);
+
+  released->deleter(released->ptr);
+  EXPECT_EQ(pool.available(), 1u);
+}
+
+TEST(MemPoolTest, AllocateSharedFanOutAcrossThreads) {
+  nstd::memory::MemPoolOptions options;
+  options.collect_stats = true;
+  nstd::memory::MemPool<int> pool(4, 8, nstd::memory::MemoryLocation::Host,
+                                  options);
+  constexpr int rounds = 200;
+
+  std::vector<std::thread> consumers;
+  for (int t = 0; t < 4; ++t) {
+    consumers.emplace_back([&pool] {
+      for (int i = 0; i < rounds; ++i) {
+        auto sb = pool.allocate_shared();
+        std::vector<nstd::memory::shared_buffer<int>> copies(3, sb);
+        auto drop = std::async(std::launch::async,
+                               [moved = std::move(copies)]() mutable {
+                                 moved.clear();
+                               });
+        sb.reset();
+        drop.wait();
+      }
+    });
+  }
+  for (auto &t : consumers) {
+    t.join();
+  }
+  EXPECT_EQ(pool.available(), 8u);
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocations, 4u * rounds);
+  EXPECT_EQ(stats.releases, 4u * rounds);
+}
+
+TEST(MemPoolTest, AllocateSharedOutlivesSharedPool) {
+  Counted::alive = 0;
+  nstd::memory::shared_buffer<Counted> survivor;
+  {
+    auto pool = nstd::memory::MemPool<Counted>::create_shared(2, 2);
+    survivor = pool->allocate_shared();
+  }
+  EXPECT_EQ(survivor.span()[1].value, 7);
+  survivor.reset();
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(MemPoolTest, AllocateSharedWeakDetachesSlot) {
+  nstd::memory::MemPool<int> pool(8, 2);
+  auto sb = pool.allocate_shared();
+  nstd::memory::weak_buffer<int> wb(sb);
+  EXPECT_EQ(wb.lock().data(), sb.data());
+  sb.reset();
+  EXPECT_TRUE(wb.expired());
+  EXPECT_EQ(pool.available(), 2u); // The block is back, the slot is not
+
+  {
+    // Both blocks in use while a weak_buffer holds a slot: the second one
+    // gets an overflow control block.
+    auto a = pool.allocate_shared();
+    auto b = pool.allocate_shared();
+    nstd::memory::weak_buffer<int> wa(a);
+    nstd::memory::weak_buffer<int> wc(b);
+    a.reset();
+    b.reset();
+    EXPECT_EQ(pool.available(), 2u);
+    EXPECT_TRUE(wc.expired());
+  }
+  wb.reset();
+
+  auto a = pool.allocate_shared();
+  auto b = pool.allocate_shared();
+  EXPECT_THROW(pool.allocate_shared(), std::runtime_error);
+}
+
+TEST(MemPoolTest, ConvertedBufferUsesPooledControlBlock) {
+  nstd::memory::MemPool<int> pool(8, 2);
+  for (int round = 0; round < 50; ++round) {
+    nstd::memory::shared_buffer<int> sb(pool.allocate());
+    nstd::memory::local_shared_buffer<int> local(pool.allocate());
+    auto copy = sb;
+    nstd::memory::weak_buffer<int> wb(copy);
+    EXPECT_EQ(sb.use_count(), 2u);
+    EXPECT_EQ(local.use_count(), 1u);
+    EXPECT_EQ(pool.available(), 0u);
+    sb.reset();
+    copy.reset();
+    local.reset();
+    EXPECT_TRUE(wb.expired());
+    EXPECT_EQ(pool.available(), 2u);
+  }
+
+  // Slots are shared with allocate_shared(), and grow while weak_buffers
+  // hold detached ones.
+  auto a = pool.allocate_shared();
+  nstd::memory::weak_buffer<int> wa(a);
+  a.reset();
+  nstd::memory::shared_buffer<int> b(pool.allocate());
+  auto c = pool.allocate_shared();
+  EXPECT_EQ(pool.available(), 0u);
+
+  // The type-erased unique_buffer still gets a heap control block.
+  b.reset();
+  nstd::memory::unique_buffer<int> erased = pool.allocate();
+  nstd::memory::shared_buffer<int> d(std::move(erased));
+  EXPECT_EQ(d.size(), 8u);
+}
+
+TEST(MemPoolTest, WeakBufferKeepsSharedPoolAlive) {
+  nstd::memory::weak_buffer<int> wb;
+  {
+    auto pool = nstd::memory::MemPool<int>::create_shared(4, 1);
+    auto sb = pool->allocate_shared();
+    wb = sb;
+  }
+  // The pool is orphaned with its block back, but still owns the slot.
+  EXPECT_TRUE(wb.expired());
+  EXPECT_FALSE(wb.lock());
+  wb.reset();
+}
+
+namespace {
+nstd::memory::MemPoolOptions with_recycling(nstd::memory::RecyclingPolicy p) {
+  nstd::memory::MemPoolOptions options;
+  options.recycling = p;
+  return options;
+}
+} // namespace
+
+TEST(MemPoolTest, LifoReusesHottestBlock) {
+  nstd::memory::MemPool<int> pool(4, 4);
+  EXPECT_EQ(pool.recycling(), nstd::memory::RecyclingPolicy::Lifo);
+  int *first = pool.acquire_block();
+  pool.release_block(first);
+  for (int i = 0; i < 8; ++i) {
+    int *block = pool.acquire_block();
+    EXPECT_EQ(block, first);
+    pool.release_block(block);
+  }
+}
+
+TEST(MemPoolTest, FifoCyclesThroughSlab) {
+  nstd::memory::MemPool<int> pool(
+      4, 4, nstd::memory::MemoryLocation::Host,
+      with_recycling(nstd::memory::RecyclingPolicy::Fifo));
+  int *base = pool.acquire_block();
+  pool.release_block(base);
+  // Block 0 went to the back of the queue behind the never-used blocks.
+  for (std::size_t i = 1; i < 13; ++i) {
+    int *block = pool.acquire_block();
+    EXPECT_EQ(block, base + (i % 4) * pool.stride());
+    pool.release_block(block);
+  }
+
+  // Out-of-order releases are reused in release order.
+  int *a = pool.acquire_block();
+  int *b = pool.acquire_block();
+  int *c = pool.acquire_block();
+  int *d = pool.acquire_block();
+  EXPECT_EQ(pool.acquire_block(), nullptr);
+  pool.release_block(c);
+  pool.release_block(a);
+  pool.release_block(d);
+  pool.release_block(b);
+  EXPECT_EQ(pool.acquire_block(), c);
+  EXPECT_EQ(pool.acquire_block(), a);
+  EXPECT_EQ(pool.acquire_block(), d);
+  EXPECT_EQ(pool.acquire_block(), b);
+  for (int *block : {a, b, c, d}) {
+    pool.release_block(block);
+  }
+  EXPECT_EQ(pool.available(), 4u);
+}
+
+TEST(MemPoolTest, SpscRingPipeline) {
+  nstd::memory::MemPoolOptions options =
+      with_recycling(nstd::memory::RecyclingPolicy::SpscRing);
+  options.numa_aware = true; // Ignored by SpscRing
+  options.collect_stats = true;
+  nstd::memory::MemPool<std::size_t> pool(
+      8, 8, nstd::memory::MemoryLocation::Host, options);
+  EXPECT_EQ(pool.node_count(), 1u);
+
+  constexpr std::size_t rounds = 5000;
+  std::mutex mtx;
+  std::condition_variable ready;
+  std::deque<std::size_t *> in_flight;
+  bool done = false;
+  std::vector<std::size_t *> order;
+  order.reserve(rounds);
+
+  std::thread consumer([&] {
+    std::size_t expected = 0;
+    while (true) {
+      std::unique_lock<std::mutex> lock(mtx);
+      ready.wait(lock, [&] { return !in_flight.empty() || done; });
+      if (in_flight.empty()) {
+        break;
+      }
+      std::size_t *block = in_flight.front();
+      in_flight.pop_front();
+      lock.unlock();
+      EXPECT_EQ(block[7], expected++);
+      pool.release_block(block);
+    }
+  });
+  for (std::size_t i = 0; i < rounds; ++i) {
+    std::size_t *block = nullptr;
+    while (!(block = pool.acquire_block())) {
+      std::this_thread::yield(); // Consumer is behind
+    }
+    order.push_back(block);
+    std::fill(block, block + 8, i);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      in_flight.push_back(block);
+    }
+    ready.notify_one();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    done = true;
+  }
+  ready.notify_one();
+  consumer.join();
+
+  // In-order releases make the producer sweep the slab sequentially.
+  for (std::size_t i = 0; i < rounds; ++i) {
+    EXPECT_EQ(order[i], order[0] + (i % 8) * pool.stride());
+  }
+  EXPECT_EQ(pool.available(), 8u);
+  EXPECT_TRUE(pool.outstanding_blocks().empty());
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocations, rounds);
+  EXPECT_EQ(stats.releases, rounds);
+}
+
+TEST(MemPoolTest, SpscRingDrainAndShared) {
+  nstd::memory::MemPool<int> pool(
+      4, 4, nstd::memory::MemoryLocation::Host,
+      with_recycling(nstd::memory::RecyclingPolicy::SpscRing));
+  auto a = pool.allocate();
+  auto b = pool.allocate_shared();
+  auto copy = b;
+  auto releaser = std::async(std::launch::async,
+                             [a = std::move(a), b = std::move(b),
+                              copy = std::move(copy)]() mutable {
+                               a.reset();
+                               b.reset();
+                               copy.reset();
+                             });
+  pool.drain();
+  releaser.wait();
+  EXPECT_EQ(pool.available(), 4u);
 }
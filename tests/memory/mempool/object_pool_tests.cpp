@@ -0,0 +1,96 @@
+#include "nstd/memory/mempool/ObjectPool.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+struct Parser {
+  static inline int constructed = 0;
+  static inline int destroyed = 0;
+  std::vector<char> scratch;
+  int resets = 0;
+
+  Parser() {
+    ++constructed;
+    scratch.reserve(1024);
+  }
+  ~Parser() { ++destroyed; }
+
+  void reset() noexcept {
+    scratch.clear(); // keeps capacity
+    ++resets;
+  }
+};
+
+class ObjectPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Parser::constructed = 0;
+    Parser::destroyed = 0;
+  }
+};
+} // namespace
+
+TEST_F(ObjectPoolTest, ConstructsOnFirstAcquire) {
+  nstd::memory::ObjectPool<Parser> pool(4);
+  EXPECT_EQ(Parser::constructed, 0);
+  EXPECT_EQ(pool.capacity(), 4u);
+
+  auto a = pool.acquire();
+  EXPECT_EQ(Parser::constructed, 1);
+  EXPECT_EQ(a->scratch.capacity(), 1024u);
+  EXPECT_EQ(pool.available(), 3u);
+}
+
+TEST_F(ObjectPoolTest, ResetInsteadOfDestroy) {
+  {
+    nstd::memory::ObjectPool<Parser> pool(1);
+    Parser *first = nullptr;
+    {
+      auto p = pool.acquire();
+      p->scratch.assign(100, 'x');
+      first = p.get();
+    }
+    EXPECT_EQ(Parser::destroyed, 0);
+
+    auto p = pool.acquire();
+    EXPECT_EQ(p.get(), first);
+    EXPECT_EQ(Parser::constructed, 1);
+    EXPECT_EQ(p->resets, 1);
+    EXPECT_TRUE(p->scratch.empty());
+    EXPECT_GE(p->scratch.capacity(), 1024u);
+  }
+  EXPECT_EQ(Parser::destroyed, 1);
+}
+
+TEST_F(ObjectPoolTest, Exhaustion) {
+  nstd::memory::ObjectPool<Parser> pool(2);
+  auto a = pool.acquire();
+  auto b = pool.acquire();
+  EXPECT_THROW(pool.acquire(), std::runtime_error);
+  b.reset();
+  EXPECT_NO_THROW(pool.acquire());
+}
+
+TEST_F(ObjectPoolTest, CustomResetPolicy) {
+  struct clear_string {
+    void operator()(std::string &s) const noexcept { s.clear(); }
+  };
+  nstd::memory::ObjectPool<std::string, clear_string> pool(1);
+  {
+    auto s = pool.acquire();
+    s->assign("a fairly long string that does not fit the SSO buffer");
+  }
+  auto s = pool.acquire();
+  EXPECT_TRUE(s->empty());
+  EXPECT_GT(s->capacity(), 15u);
+}
+
+TEST_F(ObjectPoolTest, HandleIsPointerSized) {
+  using Pool = nstd::memory::ObjectPool<Parser>;
+  static_assert(sizeof(Pool::handle_type) == 2 * sizeof(void *));
+  Pool pool(1);
+  auto h = pool.acquire();
+  EXPECT_TRUE(h);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(h.get()) % 64, 0u);
+}
@@ -0,0 +1,163 @@
+#include "nstd/memory/mempool/SharedMemPool.hpp"
+#include <gtest/gtest.h>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+/// Runs `fn` in a forked child and returns its exit status.
+template <typename Fn> int run_in_child(Fn fn) {
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    ::_exit(fn() ? 0 : 1);
+  }
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+} // namespace
+
+TEST(SharedMemPoolTest, AllocateAndRelease) {
+  auto pool = nstd::memory::SharedMemPool<int>::anonymous(64, 4);
+  EXPECT_EQ(pool.capacity(), 4u);
+  EXPECT_EQ(pool.block_size(), 64u);
+
+  {
+    auto a = pool.allocate();
+    auto b = pool.allocate();
+    EXPECT_EQ(pool.available(), 2u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.get()) % 64, 0u);
+    EXPECT_NE(a.get(), b.get());
+  }
+  EXPECT_EQ(pool.available(), 4u);
+}
+
+TEST(SharedMemPoolTest, Exhaustion) {
+  auto pool = nstd::memory::SharedMemPool<char>::anonymous(16, 1);
+  auto a = pool.allocate();
+  EXPECT_THROW(pool.allocate(), std::runtime_error);
+}
+
+TEST(SharedMemPoolTest, InvalidArgs) {
+  using Pool = nstd::memory::SharedMemPool<int>;
+  EXPECT_THROW(Pool::anonymous(0, 1), std::invalid_argument);
+  EXPECT_THROW(Pool::anonymous(1, 0), std::invalid_argument);
+}
+
+TEST(SharedMemPoolTest, ChildReleasesParentBlock) {
+  auto pool = nstd::memory::SharedMemPool<int>::anonymous(8, 2);
+
+  auto buf = pool.allocate();
+  buf.span()[0] = 42;
+  buf.span()[7] = 7;
+  auto index = pool.to_index(std::move(buf));
+  EXPECT_EQ(pool.available(), 1u);
+
+  int status = run_in_child([&] {
+    auto adopted = pool.from_index(index);
+    bool ok = adopted.span()[0] == 42 && adopted.span()[7] == 7;
+    return ok; // adopted is released back to the shared free list here
+  });
+  EXPECT_EQ(status, 0);
+  EXPECT_EQ(pool.available(), 2u);
+}
+
+TEST(SharedMemPoolTest, ParentAdoptsChildBlock) {
+  using Pool = nstd::memory::SharedMemPool<std::uint64_t>;
+  auto pool = Pool::anonymous(4, 4);
+  auto held = pool.allocate(); // So the child's block isn't the first one
+
+  // The child allocates a block, fills it and passes its index via exit code
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    auto buf = pool.allocate();
+    buf.span()[3] = 0xfeedULL;
+    // Leave it allocated for the parent
+    ::_exit(static_cast<int>(pool.to_index(std::move(buf))));
+  }
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  auto index = static_cast<Pool::index_type>(WEXITSTATUS(status));
+  EXPECT_NE(pool.block_at(index), held.get());
+  EXPECT_EQ(pool.available(), 2u);
+
+  auto adopted = pool.from_index(index);
+  EXPECT_EQ(adopted.span()[3], 0xfeedULL);
+  adopted.reset();
+  held.reset();
+  EXPECT_EQ(pool.available(), 4u);
+  EXPECT_THROW(pool.from_index(4), std::out_of_range);
+}
+
+TEST(SharedMemPoolTest, ConcurrentProcesses) {
+  auto pool = nstd::memory::SharedMemPool<int>::anonymous(16, 8);
+
+  constexpr int children = 4;
+  pid_t pids[children];
+  for (int c = 0; c < children; ++c) {
+    pids[c] = ::fork();
+    if (pids[c] == 0) {
+      for (int i = 0; i < 10000; ++i) {
+        auto buf = pool.allocate();
+        buf.span()[0] = i;
+      }
+      ::_exit(0);
+    }
+  }
+  for (pid_t pid : pids) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+  EXPECT_EQ(pool.available(), 8u);
+}
+
+TEST(SharedMemPoolTest, NamedRegion) {
+  std::string name = "/nstd_smp_test_" + std::to_string(::getpid());
+  using Pool = nstd::memory::SharedMemPool<int>;
+  Pool::unlink(name);
+
+  auto creator = Pool::create(name, 32, 2);
+  EXPECT_THROW(Pool::create(name, 32, 2), std::system_error);
+
+  auto attached = Pool::open(name);
+  EXPECT_EQ(attached.block_size(), 32u);
+  EXPECT_EQ(attached.capacity(), 2u);
+
+  auto buf = creator.allocate();
+  buf.span()[5] = 5;
+  EXPECT_EQ(attached.available(), 1u);
+
+  auto index = creator.to_index(std::move(buf));
+  {
+    auto adopted = attached.from_index(index);
+    EXPECT_EQ(adopted.span()[5], 5);
+  }
+  EXPECT_EQ(creator.available(), 2u);
+
+  EXPECT_THROW(nstd::memory::SharedMemPool<double>::open(name),
+               std::runtime_error);
+  Pool::unlink(name);
+  EXPECT_THROW(Pool::open(name), std::system_error);
+}
+
+TEST(SharedMemPoolTest, OpenRejectsUninitializedRegion) {
+  std::string name = "/nstd_smp_uninit_" + std::to_string(::getpid());
+  using Pool = nstd::memory::SharedMemPool<int>;
+  Pool::unlink(name);
+
+  // What open() sees while a creator is between shm_open() and publishing
+  // the header: first an empty region, then a sized one without the magic.
+  int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  ASSERT_GE(fd, 0);
+  EXPECT_THROW(Pool::open(name), std::runtime_error);
+  ASSERT_EQ(::ftruncate(fd, 4096), 0);
+  EXPECT_THROW(Pool::open(name), std::runtime_error);
+  ::close(fd);
+  Pool::unlink(name);
+}
+#endif
@@ -0,0 +1,81 @@
+#include "nstd/memory/mempool/SizeClassPool.hpp"
+#include <gtest/gtest.h>
+
+TEST(SizeClassPoolTest, GeometricClasses) {
+  nstd::memory::SizeClassPool<int> pool(16, 256, 2);
+  std::vector<std::size_t> expected{16, 32, 64, 128, 256};
+  EXPECT_EQ(pool.class_sizes(), expected);
+  EXPECT_EQ(pool.class_count(), 5u);
+}
+
+TEST(SizeClassPoolTest, MaxIsAlwaysLastClass) {
+  nstd::memory::SizeClassPool<int> pool(10, 100, 1);
+  EXPECT_EQ(pool.class_sizes().front(), 10u);
+  EXPECT_EQ(pool.class_sizes().back(), 100u);
+}
+
+TEST(SizeClassPoolTest, ConstructorInvalidArgs) {
+  using Pool = nstd::memory::SizeClassPool<int>;
+  EXPECT_THROW(Pool(0, 16, 1), std::invalid_argument);
+  EXPECT_THROW(Pool(16, 8, 1), std::invalid_argument);
+  EXPECT_THROW(Pool(16, 32, 0), std::invalid_argument);
+  EXPECT_THROW(Pool(16, 32, 1, 1.0), std::invalid_argument);
+}
+
+TEST(SizeClassPoolTest, AllocateReportsRequestedSize) {
+  nstd::memory::SizeClassPool<int> pool(16, 256, 2);
+
+  auto buf = pool.allocate(20);
+  EXPECT_EQ(buf.size(), 20u);
+  EXPECT_EQ(pool.size_class_pool(1).available(), 1u); // 32-element class
+
+  auto exact = pool.allocate(16);
+  EXPECT_EQ(exact.size(), 16u);
+  EXPECT_EQ(pool.size_class_pool(0).available(), 1u);
+}
+
+TEST(SizeClassPoolTest, FallsBackToLargerClass) {
+  nstd::memory::SizeClassPool<char> pool(8, 32, 1);
+
+  auto a = pool.allocate(8);
+  auto b = pool.allocate(8); // 8-class exhausted -> 16-class
+  EXPECT_EQ(b.size(), 8u);
+  EXPECT_EQ(pool.size_class_pool(1).available(), 0u);
+
+  auto c = pool.allocate(8); // -> 32-class
+  EXPECT_THROW(pool.allocate(8), std::runtime_error);
+}
+
+TEST(SizeClassPoolTest, InvalidRequestSize) {
+  nstd::memory::SizeClassPool<int> pool(16, 64, 1);
+  EXPECT_THROW(pool.allocate(0), std::invalid_argument);
+  EXPECT_THROW(pool.allocate(65), std::invalid_argument);
+}
+
+TEST(SizeClassPoolTest, FragmentationAccounting) {
+  nstd::memory::SizeClassPool<int> pool(16, 64, 2);
+
+  {
+    auto a = pool.allocate(20); // 32-class, 12 wasted
+    auto b = pool.allocate(64); // 64-class, 0 wasted
+    auto stats = pool.fragmentation();
+    EXPECT_EQ(stats.requested_elements, 84u);
+    EXPECT_EQ(stats.reserved_elements, 96u);
+    EXPECT_EQ(stats.wasted_elements(), 12u);
+    EXPECT_DOUBLE_EQ(stats.ratio(), 12.0 / 96.0);
+  }
+
+  auto stats = pool.fragmentation();
+  EXPECT_EQ(stats.requested_elements, 0u);
+  EXPECT_EQ(stats.reserved_elements, 0u);
+  EXPECT_DOUBLE_EQ(stats.ratio(), 0.0);
+}
+
+TEST(SizeClassPoolTest, BlocksReturnToTheirClass) {
+  nstd::memory::SizeClassPool<int> pool(16, 64, 1);
+  {
+    nstd::memory::unique_buffer<int> erased = pool.allocate(40);
+    EXPECT_EQ(pool.size_class_pool(2).available(), 0u);
+  }
+  EXPECT_EQ(pool.size_class_pool(2).available(), 1u);
+}
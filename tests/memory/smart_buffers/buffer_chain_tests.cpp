@@ -0,0 +1,195 @@
+#include "nstd/memory/smart_buffers/buffer_chain.hpp"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using nstd::memory::buffer_base;
+using nstd::memory::buffer_chain;
+using nstd::memory::shared_buffer;
+
+shared_buffer<char> make_text(std::string_view text) {
+  auto sb = nstd::memory::make_shared_buffer<char>(text.size());
+  std::copy(text.begin(), text.end(), sb.data());
+  return sb;
+}
+
+template <typename Chain> std::string flatten(const Chain &chain) {
+  return std::string(chain.begin(), chain.end());
+}
+} // namespace
+
+TEST(BufferChainTest, AppendPrependAndIterate) {
+  std::string header = "HDR:";
+  buffer_chain<char> chain;
+  EXPECT_TRUE(chain.empty());
+  EXPECT_EQ(chain.begin(), chain.end());
+
+  chain.append(make_text("hello "));
+  chain.append(make_text("world"));
+  chain.prepend(buffer_base<char>(header.data(), header.size()));
+  chain.append(shared_buffer<char>());              // Empty: ignored
+  chain.append(buffer_base<char>(header.data(), 0)); // Empty: ignored
+
+  EXPECT_EQ(chain.segment_count(), 3u);
+  EXPECT_EQ(chain.size(), 15u);
+  EXPECT_EQ(chain.size_bytes(), 15u);
+  EXPECT_EQ(flatten(chain), "HDR:hello world");
+  EXPECT_EQ(chain.segment(0).data(), header.data());
+
+  *chain.begin() = 'h';
+  EXPECT_EQ(header, "hDR:");
+  static_assert(std::forward_iterator<buffer_chain<char>::iterator>);
+  static_assert(std::forward_iterator<buffer_chain<char>::const_iterator>);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(BufferChainTest, IovecsFeedWritev) {
+  auto payload = make_text("0123456789");
+  std::string header = "len=4 ";
+  buffer_chain<char> chain;
+  chain.append(buffer_base<char>(header.data(), header.size()));
+  chain.append(payload.slice(3, 4));
+
+  auto iov = chain.iovecs();
+  ASSERT_EQ(iov.size(), 2u);
+  EXPECT_EQ(iov[1].iov_base, payload.data() + 3);
+  EXPECT_EQ(iov[1].iov_len, 4u);
+
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  ASSERT_EQ(::writev(fds[1], iov.data(), static_cast<int>(iov.size())), 10);
+  char out[16] = {};
+  ASSERT_EQ(::read(fds[0], out, sizeof(out)), 10);
+  EXPECT_EQ(std::string(out, 10), "len=4 3456");
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+#endif
+
+TEST(BufferChainTest, SplitSharesStraddlingSegment) {
+  auto first = make_text("abcd");
+  auto second = make_text("efgh");
+  buffer_chain<char> chain;
+  chain.append(first);
+  chain.append(second);
+  EXPECT_EQ(second.use_count(), 2u);
+
+  auto head = chain.split(6);
+  EXPECT_EQ(flatten(head), "abcdef");
+  EXPECT_EQ(flatten(chain), "gh");
+  EXPECT_EQ(head.segment_count(), 2u);
+  EXPECT_EQ(chain.segment_count(), 1u);
+  EXPECT_EQ(chain.segment(0).data(), second.data() + 2);
+  EXPECT_EQ(second.use_count(), 3u);
+
+  auto rest = chain.split(chain.size());
+  EXPECT_TRUE(chain.empty());
+  EXPECT_EQ(chain.segment_count(), 0u);
+  EXPECT_EQ(flatten(rest), "gh");
+  EXPECT_TRUE(chain.split(0).empty());
+  EXPECT_THROW(chain.split(1), std::out_of_range);
+
+  head.append(std::move(rest));
+  EXPECT_TRUE(rest.empty());
+  EXPECT_EQ(flatten(head), "abcdefgh");
+}
+
+TEST(BufferChainTest, AppendToItself) {
+  auto first = make_text("ab");
+  auto second = make_text("cd");
+  // Two segments inline: repeating them must grow the storage mid-append.
+  buffer_chain<char, 2> chain;
+  chain.append(first);
+  chain.append(second);
+
+  chain.append(std::move(chain));
+  EXPECT_EQ(chain.segment_count(), 4u);
+  EXPECT_EQ(chain.size(), 8u);
+  EXPECT_EQ(flatten(chain), "abcdabcd");
+  EXPECT_EQ(first.use_count(), 3u);
+
+  chain.clear();
+  EXPECT_EQ(first.use_count(), 1u);
+}
+
+TEST(BufferChainTest, ConsumeReleasesSegments) {
+  auto first = make_text("abc");
+  auto second = make_text("defg");
+  buffer_chain<char> chain;
+  chain.append(first);
+  chain.append(second);
+
+  chain.consume(1); // Within the first segment
+  EXPECT_EQ(flatten(chain), "bcdefg");
+  EXPECT_EQ(chain.segment(0).size(), 2u);
+  EXPECT_EQ(first.use_count(), 2u);
+
+  chain.consume(3); // Crosses into the second segment
+  EXPECT_EQ(flatten(chain), "efg");
+  EXPECT_EQ(first.use_count(), 1u);
+  EXPECT_EQ(chain.segment_count(), 1u);
+
+  EXPECT_THROW(chain.consume(4), std::out_of_range);
+  chain.consume(3);
+  EXPECT_TRUE(chain.empty());
+  EXPECT_EQ(second.use_count(), 1u);
+}
+
+TEST(BufferChainTest, GrowsPastInlineCapacity) {
+  std::vector<shared_buffer<int>> parts;
+  buffer_chain<int, 2> chain;
+  for (int i = 0; i < 20; ++i) {
+    auto sb = nstd::memory::make_shared_buffer<int>(2);
+    sb.data()[0] = 2 * i;
+    sb.data()[1] = 2 * i + 1;
+    parts.push_back(sb);
+    if (i % 2) {
+      chain.append(std::move(sb));
+    } else {
+      // Even parts go to the front, in reverse order
+      chain.prepend(std::move(sb));
+    }
+  }
+  EXPECT_EQ(chain.segment_count(), 20u);
+  EXPECT_EQ(chain.size(), 40u);
+  EXPECT_EQ(chain.segment(0).data()[0], 36);
+  EXPECT_EQ(chain.segment(19).data()[0], 38);
+
+  auto copy = chain;
+  EXPECT_EQ(parts[0].use_count(), 3u);
+  auto moved = std::move(chain);
+  EXPECT_TRUE(chain.empty());
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), moved.begin()));
+
+  moved.consume(39);
+  EXPECT_EQ(*moved.begin(), 39);
+  copy.clear();
+  moved.clear();
+  EXPECT_EQ(parts[0].use_count(), 1u);
+}
+
+TEST(BufferChainTest, AppendUniqueBufferTakesOwnership) {
+  int calls = 0;
+  {
+    buffer_chain<std::byte> chain;
+    nstd::memory::unique_buffer<std::byte> ub(
+        new std::byte[8], 8, [&calls](std::byte *p) {
+          ++calls;
+          delete[] p;
+        });
+    chain.append(std::move(ub));
+    EXPECT_FALSE(ub);
+    EXPECT_EQ(chain.size(), 8u);
+  }
+  EXPECT_EQ(calls, 1);
+}
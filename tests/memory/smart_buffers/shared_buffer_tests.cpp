@@ -1,6 +1,8 @@
 #include "../MockDeleter.hpp"
 #include "nstd/memory/smart_buffers/shared_buffer.hpp"
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 class SharedBufferTest : public ::testing::Test {
 protected:
@@ -220,3 +222,234 @@ TEST_F(SharedBufferTest, EmptyBufferHandling) {
   auto released = sb.release();
   EXPECT_FALSE(released.has_value());
 }
+
+namespace {
+struct Tracked {
+  static inline int alive = 0;
+  static inline int throw_at = -1; ///< Construction index that throws
+  int value = 5;
+  Tracked() {
+    if (alive == throw_at) {
+      throw std::runtime_error("Tracked construction failed");
+    }
+    ++alive;
+  }
+  ~Tracked() { --alive; }
+};
+} // namespace
+
+TEST_F(SharedBufferTest, MakeSharedBuffer) {
+  auto sb = nstd::memory::make_shared_buffer<int>(100);
+  EXPECT_TRUE(sb);
+  EXPECT_EQ(sb.size(), 100);
+  EXPECT_EQ(sb.use_count(), 1);
+  for (int v : sb.span()) {
+    EXPECT_EQ(v, 0); // value-initialized
+  }
+
+  auto copy = sb;
+  copy.span()[99] = 7;
+  EXPECT_EQ(sb.span()[99], 7);
+  EXPECT_EQ(sb.use_count(), 2);
+}
+
+TEST_F(SharedBufferTest, MakeSharedBufferAlignment) {
+  for (std::size_t alignment : {1u, 16u, 64u, 4096u}) {
+    auto sb = nstd::memory::make_shared_buffer<float>(3, alignment);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(sb.data()) % alignment, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(sb.data()) % alignof(float),
+              0u);
+  }
+  EXPECT_THROW(nstd::memory::make_shared_buffer<float>(3, 48),
+               std::invalid_argument);
+  EXPECT_FALSE(nstd::memory::make_shared_buffer<float>(0, 64));
+}
+
+TEST_F(SharedBufferTest, MakeSharedBufferLifetime) {
+  Tracked::alive = 0;
+  {
+    auto sb = nstd::memory::make_shared_buffer<Tracked>(
+        8, 64, nstd::memory::MemoryLocation::Host);
+    EXPECT_EQ(Tracked::alive, 8);
+    EXPECT_EQ(sb.span()[7].value, 5);
+    auto copy = sb;
+    sb.reset();
+    EXPECT_EQ(Tracked::alive, 8);
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+
+  Tracked::throw_at = 3;
+  EXPECT_THROW(nstd::memory::make_shared_buffer<Tracked>(8),
+               std::runtime_error);
+  Tracked::throw_at = -1;
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST_F(SharedBufferTest, MakeSharedBufferRelease) {
+  Tracked::alive = 0;
+  auto sb = nstd::memory::make_shared_buffer_for_overwrite<Tracked>(4);
+  Tracked *data = sb.data();
+  auto released = sb.release();
+  ASSERT_TRUE(released.has_value());
+  EXPECT_EQ(released->ptr, data);
+  EXPECT_EQ(released->count, 4);
+  EXPECT_EQ(Tracked::alive, 4);
+  released->deleter(released->ptr);
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST_F(SharedBufferTest, Slice) {
+  Tracked::alive = 0;
+  nstd::memory::shared_buffer<Tracked> header;
+  nstd::memory::shared_buffer<Tracked> payload;
+  {
+    auto packet = nstd::memory::make_shared_buffer<Tracked>(10);
+    packet.span()[2].value = 2;
+    packet.span()[4].value = 4;
+
+    header = packet.slice(0, 4);
+    payload = packet.slice(4);
+    EXPECT_EQ(packet.use_count(), 3);
+    EXPECT_EQ(header.size(), 4);
+    EXPECT_EQ(payload.size(), 6);
+    EXPECT_EQ(header.data(), packet.data());
+    EXPECT_EQ(payload.data(), packet.data() + 4);
+    EXPECT_EQ(header.span()[2].value, 2);
+    EXPECT_EQ(payload.span()[0].value, 4);
+
+    auto nested = payload.slice(1, 2);
+    EXPECT_EQ(nested.data(), packet.data() + 5);
+    EXPECT_EQ(nested.size(), 2);
+  }
+  // The packet handle is gone; the slices keep the whole allocation alive.
+  EXPECT_EQ(Tracked::alive, 10);
+  EXPECT_EQ(header.use_count(), 2);
+  header.reset();
+  EXPECT_EQ(Tracked::alive, 10);
+  payload.reset();
+  EXPECT_EQ(Tracked::alive, 0);
+}
+
+TEST_F(SharedBufferTest, SliceBounds) {
+  auto sb = nstd::memory::make_shared_buffer<int>(8);
+  EXPECT_THROW(sb.slice(9), std::out_of_range);
+  EXPECT_THROW(sb.slice(4, 5), std::out_of_range);
+  EXPECT_THROW(sb.slice(1, std::numeric_limits<std::size_t>::max()),
+               std::out_of_range);
+  EXPECT_FALSE(sb.slice(8));
+  EXPECT_FALSE(sb.slice(3, 0));
+  EXPECT_EQ(sb.slice(0, 8).data(), sb.data());
+  EXPECT_EQ(sb.use_count(), 1);
+
+  nstd::memory::shared_buffer<int> empty;
+  EXPECT_FALSE(empty.slice(0));
+  EXPECT_THROW(empty.slice(1), std::out_of_range);
+}
+
+TEST_F(SharedBufferTest, ReleaseSlice) {
+  auto sb = nstd::memory::make_shared_buffer<int>(8);
+  auto tail = sb.slice(6);
+  sb.reset();
+  auto released = tail.release();
+  ASSERT_TRUE(released.has_value());
+  EXPECT_EQ(released->count, 2);
+  released->deleter(released->ptr); // Frees the whole allocation
+}
+
+TEST_F(SharedBufferTest, CastSharesOwnership) {
+  auto bytes = nstd::memory::make_shared_buffer<std::uint8_t>(16, 16);
+  auto words = nstd::memory::shared_buffer_cast<std::uint32_t>(bytes);
+  EXPECT_EQ(static_cast<void *>(words.data()),
+            static_cast<void *>(bytes.data()));
+  EXPECT_EQ(words.size(), 4);
+  EXPECT_EQ(bytes.use_count(), 2);
+
+  words.data()[1] = 0xFFFFFFFF;
+  EXPECT_EQ(bytes.data()[4], 0xFF);
+
+  auto moved = nstd::memory::shared_buffer_cast<std::uint16_t>(
+      std::move(words));
+  EXPECT_FALSE(words);
+  EXPECT_EQ(moved.size(), 8);
+  EXPECT_EQ(bytes.use_count(), 2);
+  bytes.reset();
+  EXPECT_EQ(moved.use_count(), 1);
+}
+
+TEST_F(SharedBufferTest, CastChecksLayout) {
+  auto bytes = nstd::memory::make_shared_buffer<std::uint8_t>(16, 16);
+
+  auto odd = bytes.slice(1, 8);
+  EXPECT_THROW(nstd::memory::shared_buffer_cast<std::uint32_t>(odd),
+               std::invalid_argument);
+  auto ragged = bytes.slice(0, 6);
+  EXPECT_THROW(
+      nstd::memory::shared_buffer_cast<std::uint32_t>(std::move(ragged)),
+      std::invalid_argument);
+  // A failed cast leaves the source untouched.
+  EXPECT_TRUE(ragged);
+  EXPECT_EQ(ragged.size(), 6);
+  EXPECT_EQ(bytes.use_count(), 3);
+
+  auto tail = nstd::memory::shared_buffer_cast<std::uint64_t>(bytes.slice(8));
+  EXPECT_EQ(tail.size(), 1);
+  EXPECT_EQ(static_cast<void *>(tail.data()),
+            static_cast<void *>(bytes.data() + 8));
+
+  nstd::memory::shared_buffer<std::uint8_t> empty;
+  EXPECT_FALSE(nstd::memory::shared_buffer_cast<std::uint32_t>(empty));
+}
+
+TEST_F(SharedBufferTest, LocalRefcount) {
+  auto sb = nstd::memory::make_shared_buffer<int, nstd::memory::local_refcount>(
+      4);
+  static_assert(std::is_same_v<decltype(sb),
+                               nstd::memory::local_shared_buffer<int>>);
+  {
+    auto copy = sb;
+    auto slice = copy.slice(2);
+    EXPECT_EQ(sb.use_count(), 3);
+  }
+  EXPECT_EQ(sb.use_count(), 1);
+
+  auto bytes = nstd::memory::shared_buffer_cast<std::uint8_t>(sb);
+  EXPECT_EQ(bytes.use_count(), 2);
+  bytes.reset();
+  auto released = sb.release();
+  ASSERT_TRUE(released.has_value());
+  released->deleter(released->ptr);
+}
+
+TEST_F(SharedBufferTest, LocalToAtomicCrossesThreads) {
+  Tracked::alive = 0;
+  auto local =
+      nstd::memory::make_shared_buffer<Tracked, nstd::memory::local_refcount>(
+          2);
+
+  // The conversion flags the block: the local owners switch to atomic
+  // updates while another thread copies and drops its own handles.
+  nstd::memory::shared_buffer<Tracked> shared = local;
+  EXPECT_EQ(local.use_count(), 2);
+  std::thread worker([buffer = std::move(shared)]() mutable {
+    for (int i = 0; i < 10000; ++i) {
+      auto copy = buffer;
+    }
+  });
+  std::vector<nstd::memory::local_shared_buffer<Tracked>> copies;
+  for (int i = 0; i < 10000; ++i) {
+    copies.push_back(local);
+    if (copies.size() == 16) {
+      copies.clear();
+    }
+  }
+  worker.join();
+  copies.clear();
+  EXPECT_EQ(local.use_count(), 1);
+
+  nstd::memory::shared_buffer<Tracked> moved = std::move(local);
+  EXPECT_FALSE(local);
+  EXPECT_EQ(moved.use_count(), 1);
+  EXPECT_EQ(Tracked::alive, 2);
+  moved.reset();
+  EXPECT_EQ(Tracked::alive, 0);
+}
@@ -3,6 +3,10 @@
 #include "nstd/memory/smart_buffers/unique_buffer.hpp"
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
 class UniqueBufferTest : public ::testing::Test {
 protected:
   void SetUp() override { MockDeleter::deleted = false; }
@@ -156,3 +160,193 @@ TEST_F(UniqueBufferTest, ExceptionSafetyInReset) {
     FAIL() << "reset() should handle exceptions gracefully";
   }
 }
+
+namespace {
+struct CountingDeleter {
+  int *calls = nullptr;
+  void operator()(int *p) const noexcept {
+    ++*calls;
+    delete[] p;
+  }
+};
+} // namespace
+
+TEST_F(UniqueBufferTest, CustomDeleterType) {
+  int calls = 0;
+  {
+    nstd::memory::unique_buffer<int, CountingDeleter> buf(
+        new int[4], 4, CountingDeleter{&calls});
+    static_assert(sizeof(buf) == sizeof(nstd::memory::buffer_base<int>) +
+                                     sizeof(CountingDeleter));
+    EXPECT_TRUE(buf);
+    EXPECT_EQ(buf.size(), 4);
+  }
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(UniqueBufferTest, ConvertCustomDeleterToDefault) {
+  int calls = 0;
+  auto *ptr = new int[4];
+  nstd::memory::unique_buffer<int, CountingDeleter> src(
+      ptr, 4, CountingDeleter{&calls});
+  nstd::memory::unique_buffer<int> dst(std::move(src));
+
+  EXPECT_FALSE(src);
+  EXPECT_EQ(dst.get(), ptr);
+  EXPECT_EQ(dst.size(), 4);
+  EXPECT_EQ(calls, 0);
+
+  dst.reset();
+  EXPECT_EQ(calls, 1);
+}
+
+namespace {
+/// Counting deleter whose moves throw once `*fail` is set
+struct ThrowingMoveDeleter {
+  int *calls = nullptr;
+  bool *fail = nullptr;
+  ThrowingMoveDeleter(int *c, bool *f) : calls(c), fail(f) {}
+  ThrowingMoveDeleter(const ThrowingMoveDeleter &) = default;
+  ThrowingMoveDeleter(ThrowingMoveDeleter &&other)
+      : calls(other.calls), fail(other.fail) {
+    if (*fail) {
+      throw std::bad_alloc();
+    }
+  }
+  void operator()(int *p) const noexcept {
+    ++*calls;
+    delete[] p;
+  }
+};
+} // namespace
+
+TEST_F(UniqueBufferTest, FailedConversionKeepsOwnership) {
+  // noexcept follows the deleter conversion.
+  static_assert(!std::is_nothrow_constructible_v<
+                nstd::memory::unique_buffer<int>,
+                nstd::memory::unique_buffer<int, ThrowingMoveDeleter> &&>);
+
+  int calls = 0;
+  bool fail = false;
+  auto *ptr = new int[4];
+  nstd::memory::unique_buffer<int, ThrowingMoveDeleter> src(
+      ptr, 4, ThrowingMoveDeleter(&calls, &fail));
+  fail = true;
+  EXPECT_THROW(nstd::memory::unique_buffer<int>{std::move(src)},
+               std::bad_alloc);
+  EXPECT_TRUE(src);
+  EXPECT_EQ(src.get(), ptr);
+  EXPECT_EQ(calls, 0);
+
+  fail = false;
+  src.reset();
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(UniqueBufferTest, ReleaseCustomDeleter) {
+  int calls = 0;
+  auto *ptr = new int[2];
+  nstd::memory::unique_buffer<int, CountingDeleter> buf(
+      ptr, 2, CountingDeleter{&calls});
+
+  auto released = buf.release();
+  EXPECT_FALSE(buf);
+  EXPECT_EQ(released.ptr, ptr);
+  EXPECT_EQ(calls, 0);
+
+  released.deleter(released.ptr);
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(UniqueBufferTest, CastKeepsDeleter) {
+  int calls = 0;
+  auto *ptr = new int[4];
+  nstd::memory::unique_buffer<int, CountingDeleter> src(
+      ptr, 4, CountingDeleter{&calls});
+
+  auto bytes = nstd::memory::unique_buffer_cast<std::uint8_t>(std::move(src));
+  EXPECT_FALSE(src);
+  EXPECT_EQ(static_cast<void *>(bytes.get()), static_cast<void *>(ptr));
+  EXPECT_EQ(bytes.size(), 4 * sizeof(int));
+  EXPECT_EQ(calls, 0);
+
+  // Converts to the default, type-erased deleter like any other buffer.
+  nstd::memory::unique_buffer<std::uint8_t> erased(std::move(bytes));
+  erased.reset();
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(UniqueBufferTest, CastChecksLayout) {
+  int calls = 0;
+  nstd::memory::unique_buffer<int, CountingDeleter> src(
+      new int[3], 3, CountingDeleter{&calls});
+  EXPECT_THROW(nstd::memory::unique_buffer_cast<std::uint64_t>(std::move(src)),
+               std::invalid_argument);
+  EXPECT_TRUE(src);
+  EXPECT_EQ(src.size(), 3);
+
+  nstd::memory::unique_buffer<int> empty;
+  EXPECT_FALSE(nstd::memory::unique_buffer_cast<float>(std::move(empty)));
+  src.reset();
+  EXPECT_EQ(calls, 1);
+}
+
+namespace {
+struct Counted {
+  static inline int alive = 0;
+  int value = 7;
+  Counted() { ++alive; }
+  ~Counted() { --alive; }
+};
+} // namespace
+
+TEST_F(UniqueBufferTest, MakeUniqueBufferAligned) {
+  for (std::size_t alignment : {16u, 64u, 4096u}) {
+    auto buf = nstd::memory::make_unique_buffer<
+        float, nstd::memory::InitPolicy::Uninitialized>(100, alignment);
+    ASSERT_TRUE(buf);
+    EXPECT_EQ(buf.size(), 100u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buf.get()) % alignment, 0u);
+    buf.get()[99] = 1.0f;
+  }
+  static_assert(sizeof(nstd::memory::unique_buffer<
+                       float, nstd::memory::aligned_deleter<float>>) ==
+                sizeof(nstd::memory::buffer_base<float>) + sizeof(std::size_t));
+
+  EXPECT_THROW(nstd::memory::make_unique_buffer<int>(4, 48),
+               std::invalid_argument);
+  EXPECT_FALSE(nstd::memory::make_unique_buffer<int>(0, 64));
+}
+
+template <typename T, nstd::memory::InitPolicy Init>
+concept can_make_unique_buffer =
+    requires { nstd::memory::make_unique_buffer<T, Init>(1); };
+
+TEST_F(UniqueBufferTest, MakeUniqueBufferInitPolicies) {
+  auto zeroed = nstd::memory::make_unique_buffer<
+      std::uint64_t, nstd::memory::InitPolicy::Zeroed>(33, 64);
+  EXPECT_TRUE(std::all_of(zeroed.get(), zeroed.get() + zeroed.size(),
+                          [](std::uint64_t v) { return v == 0; }));
+
+  auto valued = nstd::memory::make_unique_buffer<
+      int, nstd::memory::InitPolicy::Value>(9, alignof(int));
+  EXPECT_TRUE(std::all_of(valued.get(), valued.get() + valued.size(),
+                          [](int v) { return v == 0; }));
+
+  // Zeroed on a non-trivial type is rejected at compile time.
+  static_assert(
+      !can_make_unique_buffer<Counted, nstd::memory::InitPolicy::Zeroed>);
+  static_assert(can_make_unique_buffer<Counted,
+                                       nstd::memory::InitPolicy::Value>);
+  {
+    auto objects = nstd::memory::make_unique_buffer<
+        Counted, nstd::memory::InitPolicy::Uninitialized>(5, 64);
+    EXPECT_EQ(Counted::alive, 5);
+    EXPECT_EQ(objects.get()[4].value, 7);
+
+    // Converts to the type-erased default and keeps destroying correctly.
+    nstd::memory::unique_buffer<Counted> erased(std::move(objects));
+    EXPECT_EQ(Counted::alive, 5);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
@@ -0,0 +1,161 @@
+#include "nstd/memory/smart_buffers/weak_buffer.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using nstd::memory::shared_buffer;
+using nstd::memory::weak_buffer;
+
+TEST(WeakBufferTest, DefaultIsExpired) {
+  weak_buffer<int> wb;
+  EXPECT_TRUE(wb.expired());
+  EXPECT_EQ(wb.use_count(), 0u);
+  EXPECT_FALSE(wb.lock());
+
+  weak_buffer<int> from_empty{shared_buffer<int>()};
+  EXPECT_TRUE(from_empty.expired());
+}
+
+TEST(WeakBufferTest, LockWhileOwned) {
+  auto sb = nstd::memory::make_shared_buffer<int>(8);
+  sb.span()[3] = 42;
+  weak_buffer<int> wb(sb);
+  EXPECT_FALSE(wb.expired());
+  EXPECT_EQ(wb.use_count(), 1u);
+
+  auto locked = wb.lock();
+  ASSERT_TRUE(locked);
+  EXPECT_EQ(locked.data(), sb.data());
+  EXPECT_EQ(locked.size(), 8u);
+  EXPECT_EQ(locked.span()[3], 42);
+  EXPECT_EQ(sb.use_count(), 2u);
+
+  sb.reset();
+  EXPECT_FALSE(wb.expired());
+  locked.reset();
+  EXPECT_TRUE(wb.expired());
+  EXPECT_FALSE(wb.lock());
+}
+
+TEST(WeakBufferTest, DeleterRunsBeforeLastWeakDrops) {
+  bool deleted = false;
+  weak_buffer<int> wb;
+  {
+    shared_buffer<int> sb(new int[4], 4, [&deleted](int *p) {
+      deleted = true;
+      delete[] p;
+    });
+    wb = sb;
+    auto copy = wb;
+    EXPECT_EQ(copy.use_count(), 1u);
+  }
+  // The data is gone as soon as the last owner drops; only the control block
+  // lives on for the weak_buffer.
+  EXPECT_TRUE(deleted);
+  EXPECT_TRUE(wb.expired());
+  wb.reset();
+  EXPECT_TRUE(wb.expired());
+}
+
+namespace {
+struct Tracked {
+  static inline int alive = 0;
+  Tracked() { ++alive; }
+  ~Tracked() { --alive; }
+};
+} // namespace
+
+TEST(WeakBufferTest, InlineBlockOutlivesElements) {
+  weak_buffer<Tracked> wb;
+  {
+    auto sb = nstd::memory::make_shared_buffer<Tracked>(5);
+    EXPECT_EQ(Tracked::alive, 5);
+    wb = sb;
+  }
+  EXPECT_EQ(Tracked::alive, 0);
+  EXPECT_TRUE(wb.expired());
+}
+
+TEST(WeakBufferTest, SliceLocksIntoSlice) {
+  auto sb = nstd::memory::make_shared_buffer<int>(10);
+  auto tail = sb.slice(6);
+  weak_buffer<int> wb(tail);
+  sb.reset();
+  tail.reset();
+  EXPECT_TRUE(wb.expired());
+
+  sb = nstd::memory::make_shared_buffer<int>(10);
+  wb = sb.slice(2, 3);
+  auto locked = wb.lock();
+  EXPECT_EQ(locked.data(), sb.data() + 2);
+  EXPECT_EQ(locked.size(), 3u);
+}
+
+TEST(WeakBufferTest, ReleaseExpiresObservers) {
+  auto sb = nstd::memory::make_shared_buffer<int>(4);
+  weak_buffer<int> wb(sb);
+  auto released = sb.release();
+  ASSERT_TRUE(released.has_value());
+  EXPECT_TRUE(wb.expired());
+  EXPECT_FALSE(wb.lock());
+
+  released->deleter(released->ptr);
+  EXPECT_TRUE(wb.expired());
+}
+
+TEST(WeakBufferTest, MoveAndSwap) {
+  auto a = nstd::memory::make_shared_buffer<int>(2);
+  auto b = nstd::memory::make_shared_buffer<int>(3);
+  weak_buffer<int> wa(a);
+  weak_buffer<int> wb(b);
+  wa.swap(wb);
+  EXPECT_EQ(wa.lock().data(), b.data());
+  EXPECT_EQ(wb.lock().data(), a.data());
+
+  weak_buffer<int> moved(std::move(wa));
+  EXPECT_TRUE(wa.expired());
+  EXPECT_EQ(moved.lock().size(), 3u);
+  wb = std::move(moved);
+  EXPECT_EQ(wb.lock().data(), b.data());
+}
+
+TEST(WeakBufferTest, LocalRefcount) {
+  auto sb = nstd::memory::make_shared_buffer<int, nstd::memory::local_refcount>(
+      4);
+  weak_buffer<int, nstd::memory::local_refcount> wb(sb);
+  auto locked = wb.lock();
+  EXPECT_EQ(sb.use_count(), 2u);
+  sb.reset();
+  locked.reset();
+  EXPECT_TRUE(wb.expired());
+  EXPECT_FALSE(wb.lock());
+}
+
+TEST(WeakBufferTest, LockRacesLastOwner) {
+  // A lock() either wins a reference before the last owner drops, or sees the
+  // data gone; it must never resurrect freed data.
+  for (int round = 0; round < 200; ++round) {
+    std::atomic<int> *value = new std::atomic<int>(7);
+    shared_buffer<std::atomic<int>> sb(value, 1, [](std::atomic<int> *p) {
+      p->store(-1);
+      delete p;
+    });
+    weak_buffer<std::atomic<int>> wb(sb);
+    std::vector<std::thread> observers;
+    for (int t = 0; t < 3; ++t) {
+      observers.emplace_back([wb] {
+        for (int i = 0; i < 50; ++i) {
+          if (auto locked = wb.lock()) {
+            EXPECT_EQ(locked.span()[0].load(), 7);
+          }
+        }
+      });
+    }
+    sb.reset();
+    for (auto &t : observers) {
+      t.join();
+    }
+    EXPECT_TRUE(wb.expired());
+  }
+}